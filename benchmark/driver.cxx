@@ -0,0 +1,872 @@
+// file      : benchmark/driver.cxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+// Benchmark the runtime hot paths with the SQLite database. Every
+// operation is run with each of the connection factories against an
+// in-memory and an on-disk database and the results are written as JSON.
+// For example:
+//
+// driver --objects 10000 --repeat 3 --output bench_output.json
+//
+
+#include <memory>   // std::auto_ptr, std::unique_ptr
+#include <string>
+#include <vector>
+#include <cstdio>   // std::remove
+#include <cstdlib>  // std::strtoul
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include <sys/time.h> // gettimeofday
+
+#include <odb/database.hxx>
+#include <odb/transaction.hxx>
+#include <odb/schema-catalog.hxx>
+#include <odb/details/config.hxx> // ODB_CXX11
+
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/connection-factory.hxx>
+#include <odb/sqlite/transaction.hxx>
+#include <odb/sqlite/query-builder.hxx>
+
+#include "fixtures.hxx"
+#include "fixtures-odb.hxx"
+
+using namespace std;
+using namespace odb::core;
+
+namespace sqlite = odb::sqlite;
+
+#ifdef ODB_CXX11
+typedef unique_ptr<sqlite::connection_factory> factory_ptr;
+typedef unique_ptr<sqlite::database> database_ptr;
+#else
+typedef auto_ptr<sqlite::connection_factory> factory_ptr;
+typedef auto_ptr<sqlite::database> database_ptr;
+#endif
+
+// Number of distinct item::num values. Each of them is queried for
+// separately.
+//
+static const int nums = 100;
+
+// Number of elements in each bag::tags container.
+//
+static const size_t tags = 10;
+
+// Number of times each object is looked up in the session.
+//
+static const size_t session_passes = 10;
+
+// Objects persisted in a session of the type the class is generated
+// for. The session caches pointers to the objects so they must not
+// move while it is alive.
+//
+template <typename T>
+struct session_state
+{
+  typedef
+  typename odb::object_traits_impl<T, odb::id_sqlite>::pointer_cache_traits::
+  session_type session_type;
+
+  session_state (): session (0) {}
+  ~session_state () {delete session;}
+
+  session_type* session;
+  vector<T> objects;
+
+private:
+  session_state (const session_state&);
+  session_state& operator= (const session_state&);
+};
+
+// State shared by the operations of one run.
+//
+struct context
+{
+  context (sqlite::database& d, size_t n): db (d), objects (n) {}
+
+  sqlite::database& db;
+  size_t objects;
+
+  vector<item> items;
+  vector<bag> bags;
+  vector<unsigned long> shapes;
+
+  session_state<item> session;           // odb::session
+  session_state<hashed_item> hash_session; // odb::hash_session
+};
+
+// Run the operation and return the number of objects it handled.
+//
+typedef size_t (*operation_function) (context&);
+
+struct operation
+{
+  const char* name;
+  operation_function function;
+};
+
+// Simple objects.
+//
+
+static size_t
+simple_persist (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (size_t i (0); i != c.objects; ++i)
+  {
+    ostringstream os;
+    os << "item " << i;
+
+    c.items.push_back (
+      item (static_cast<int> (i % nums), os.str (), i * 0.5));
+    c.db.persist (c.items.back ());
+  }
+
+  t.commit ();
+  return c.objects;
+}
+
+static size_t
+simple_find (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (vector<item>::iterator i (c.items.begin ()); i != c.items.end (); ++i)
+  {
+    item* o (c.db.find<item> (i->id));
+    delete o;
+  }
+
+  t.commit ();
+  return c.items.size ();
+}
+
+static size_t
+simple_load (context& c)
+{
+  transaction t (c.db.begin ());
+
+  item o;
+  for (vector<item>::iterator i (c.items.begin ()); i != c.items.end (); ++i)
+    c.db.load (i->id, o);
+
+  t.commit ();
+  return c.items.size ();
+}
+
+static size_t
+simple_update (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (vector<item>::iterator i (c.items.begin ()); i != c.items.end (); ++i)
+  {
+    i->value += 1;
+    c.db.update (*i);
+  }
+
+  t.commit ();
+  return c.items.size ();
+}
+
+static size_t
+simple_query_ (context& c, bool cache)
+{
+  typedef odb::query<item> query;
+  typedef odb::result<item> result;
+
+  size_t n (0);
+  transaction t (c.db.begin ());
+
+  for (int v (0); v != nums; ++v)
+  {
+    // SQLite results are streamed from the statement unless cached.
+    //
+    result r (c.db.query<item> (query::num == v));
+
+    if (cache)
+      r.cache ();
+
+    for (result::iterator i (r.begin ()); i != r.end (); ++i)
+    {
+      const item& o (*i);
+      n += o.id != 0 ? 1 : 0;
+    }
+  }
+
+  t.commit ();
+  return n;
+}
+
+static size_t
+simple_query (context& c)
+{
+  return simple_query_ (c, false);
+}
+
+static size_t
+simple_query_cache (context& c)
+{
+  return simple_query_ (c, true);
+}
+
+// Same as query but with the predicate built with query_builder. The
+// builder is built once and re-executed with the by-reference parameter
+// updated.
+//
+static size_t
+simple_query_builder (context& c)
+{
+  typedef odb::query<item> query;
+  typedef odb::result<item> result;
+
+  size_t n (0);
+  transaction t (c.db.begin ());
+
+  int v (0);
+  sqlite::query_builder q;
+  q += query::num;
+  q += "=";
+  q += query::_ref (v);
+
+  for (; v != nums; ++v)
+  {
+    result r (c.db.query<item> (q));
+
+    for (result::iterator i (r.begin ()); i != r.end (); ++i)
+    {
+      const item& o (*i);
+      n += o.id != 0 ? 1 : 0;
+    }
+  }
+
+  t.commit ();
+  return n;
+}
+
+static size_t
+simple_prepared_query (context& c)
+{
+  typedef odb::query<item> query;
+  typedef odb::prepared_query<item> prep_query;
+  typedef odb::result<item> result;
+
+  size_t n (0);
+  transaction t (c.db.begin ());
+
+  // A prepared query belongs to the connection it was prepared on so it
+  // has to be prepared in every transaction with the new_ factory.
+  //
+  int v (0);
+  prep_query pq (
+    c.db.prepare_query<item> ("benchmark-item-num",
+                              query::num == query::_ref (v)));
+
+  for (; v != nums; ++v)
+  {
+    result r (pq.execute ());
+
+    for (result::iterator i (r.begin ()); i != r.end (); ++i)
+    {
+      const item& o (*i);
+      n += o.id != 0 ? 1 : 0;
+    }
+  }
+
+  t.commit ();
+  return n;
+}
+
+static size_t
+simple_erase (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (vector<item>::iterator i (c.items.begin ()); i != c.items.end (); ++i)
+    c.db.erase<item> (i->id);
+
+  t.commit ();
+  return c.items.size ();
+}
+
+// Same as the above operations but with the objects passed to the
+// database as a range which item, declared with bulk(1000), handles in
+// batches.
+//
+static size_t
+simple_persist_range (context& c)
+{
+  c.items.clear ();
+  c.items.reserve (c.objects);
+
+  for (size_t i (0); i != c.objects; ++i)
+  {
+    ostringstream os;
+    os << "item " << i;
+
+    c.items.push_back (
+      item (static_cast<int> (i % nums), os.str (), i * 0.5));
+  }
+
+  transaction t (c.db.begin ());
+  c.db.persist (c.items.begin (), c.items.end ());
+  t.commit ();
+
+  return c.objects;
+}
+
+static size_t
+simple_update_range (context& c)
+{
+  for (vector<item>::iterator i (c.items.begin ()); i != c.items.end (); ++i)
+    i->value += 1;
+
+  transaction t (c.db.begin ());
+  c.db.update (c.items.begin (), c.items.end ());
+  t.commit ();
+
+  return c.items.size ();
+}
+
+static size_t
+simple_erase_range (context& c)
+{
+  vector<unsigned long> ids;
+  ids.reserve (c.items.size ());
+
+  for (vector<item>::iterator i (c.items.begin ()); i != c.items.end (); ++i)
+    ids.push_back (i->id);
+
+  transaction t (c.db.begin ());
+  c.db.erase<item> (ids.begin (), ids.end ());
+  t.commit ();
+
+  return ids.size ();
+}
+
+// Containers.
+//
+
+static size_t
+container_persist (context& c)
+{
+  size_t n (c.objects / tags != 0 ? c.objects / tags : 1);
+  transaction t (c.db.begin ());
+
+  for (size_t i (0); i != n; ++i)
+  {
+    ostringstream os;
+    os << "bag " << i;
+
+    c.bags.push_back (bag (os.str ()));
+    bag& b (c.bags.back ());
+
+    for (size_t j (0); j != tags; ++j)
+    {
+      ostringstream os;
+      os << "tag " << j;
+      b.tags.push_back (os.str ());
+    }
+
+    c.db.persist (b);
+  }
+
+  t.commit ();
+  return n;
+}
+
+static size_t
+container_load (context& c)
+{
+  transaction t (c.db.begin ());
+
+  bag o;
+  for (vector<bag>::iterator i (c.bags.begin ()); i != c.bags.end (); ++i)
+    c.db.load (i->id, o);
+
+  t.commit ();
+  return c.bags.size ();
+}
+
+static size_t
+container_update (context& c)
+{
+  transaction t (c.db.begin ());
+
+  // Modify one element and add another so that both the update and
+  // insert paths are taken.
+  //
+  for (vector<bag>::iterator i (c.bags.begin ()); i != c.bags.end (); ++i)
+  {
+    i->tags.front () += '+';
+    i->tags.push_back ("extra");
+    c.db.update (*i);
+  }
+
+  t.commit ();
+  return c.bags.size ();
+}
+
+static size_t
+container_erase (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (vector<bag>::iterator i (c.bags.begin ()); i != c.bags.end (); ++i)
+    c.db.erase<bag> (i->id);
+
+  t.commit ();
+  return c.bags.size ();
+}
+
+// Polymorphic objects.
+//
+
+static size_t
+polymorphic_persist (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (size_t i (0); i != c.objects; ++i)
+  {
+    ostringstream os;
+    os << "circle " << i;
+
+    circle o (os.str (), i * 0.5);
+    c.db.persist (o);
+    c.shapes.push_back (o.id);
+  }
+
+  t.commit ();
+  return c.objects;
+}
+
+// Load through the root so that the derived part is loaded with the
+// polymorphic dispatch.
+//
+static size_t
+polymorphic_find (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (vector<unsigned long>::iterator i (c.shapes.begin ());
+       i != c.shapes.end ();
+       ++i)
+  {
+    shape* o (c.db.find<shape> (*i));
+    delete o;
+  }
+
+  t.commit ();
+  return c.shapes.size ();
+}
+
+static size_t
+polymorphic_query (context& c)
+{
+  typedef odb::result<shape> result;
+
+  size_t n (0);
+  transaction t (c.db.begin ());
+
+  result r (c.db.query<shape> ());
+  for (result::iterator i (r.begin ()); i != r.end (); ++i)
+  {
+    const shape& o (*i);
+    n += o.id != 0 ? 1 : 0;
+  }
+
+  t.commit ();
+  return n;
+}
+
+static size_t
+polymorphic_erase (context& c)
+{
+  transaction t (c.db.begin ());
+
+  for (vector<unsigned long>::iterator i (c.shapes.begin ());
+       i != c.shapes.end ();
+       ++i)
+    c.db.erase<shape> (*i);
+
+  t.commit ();
+  return c.shapes.size ();
+}
+
+// Sessions.
+//
+
+template <typename T, session_state<T> context::*S>
+static size_t
+session_persist (context& c)
+{
+  session_state<T>& s (c.*S);
+
+  s.objects.reserve (c.objects);
+  s.session = new typename session_state<T>::session_type;
+
+  transaction t (c.db.begin ());
+
+  for (size_t i (0); i != c.objects; ++i)
+  {
+    ostringstream os;
+    os << "item " << i;
+
+    s.objects.push_back (T (static_cast<int> (i % nums), os.str (), i * 0.5));
+    c.db.persist (s.objects.back ());
+  }
+
+  t.commit ();
+  return c.objects;
+}
+
+// Every lookup is a session cache hit and does not reach the database.
+//
+template <typename T, session_state<T> context::*S>
+static size_t
+session_find (context& c)
+{
+  session_state<T>& s (c.*S);
+
+  size_t n (0);
+  transaction t (c.db.begin ());
+
+  for (size_t p (0); p != session_passes; ++p)
+  {
+    for (typename vector<T>::iterator i (s.objects.begin ());
+         i != s.objects.end ();
+         ++i)
+    {
+      n += c.db.find<T> (i->id) == &*i ? 1 : 0;
+    }
+  }
+
+  t.commit ();
+  return n;
+}
+
+template <typename T, session_state<T> context::*S>
+static size_t
+session_erase (context& c)
+{
+  session_state<T>& s (c.*S);
+
+  transaction t (c.db.begin ());
+
+  for (typename vector<T>::iterator i (s.objects.begin ());
+       i != s.objects.end ();
+       ++i)
+    c.db.erase<T> (i->id);
+
+  t.commit ();
+
+  size_t n (s.objects.size ());
+
+  delete s.session;
+  s.session = 0;
+  s.objects.clear ();
+
+  return n;
+}
+
+// The operations are run in this order on the same database.
+//
+static const operation operations[] =
+{
+  {"persist", &simple_persist},
+  {"find", &simple_find},
+  {"load", &simple_load},
+  {"update", &simple_update},
+  {"query", &simple_query},
+  {"query_cache", &simple_query_cache},
+  {"query_builder", &simple_query_builder},
+  {"prepared_query", &simple_prepared_query},
+  {"erase", &simple_erase},
+  {"persist_range", &simple_persist_range},
+  {"update_range", &simple_update_range},
+  {"erase_range", &simple_erase_range},
+  {"container_persist", &container_persist},
+  {"container_load", &container_load},
+  {"container_update", &container_update},
+  {"container_erase", &container_erase},
+  {"polymorphic_persist", &polymorphic_persist},
+  {"polymorphic_find", &polymorphic_find},
+  {"polymorphic_query", &polymorphic_query},
+  {"polymorphic_erase", &polymorphic_erase},
+  {"session_persist", &session_persist<item, &context::session>},
+  {"session_find", &session_find<item, &context::session>},
+  {"session_erase", &session_erase<item, &context::session>},
+  {"hash_session_persist",
+   &session_persist<hashed_item, &context::hash_session>},
+  {"hash_session_find", &session_find<hashed_item, &context::hash_session>},
+  {"hash_session_erase", &session_erase<hashed_item, &context::hash_session>}
+};
+
+static const size_t operation_count (
+  sizeof (operations) / sizeof (operations[0]));
+
+enum factory_kind
+{
+  factory_single,
+  factory_new,
+  factory_pool
+};
+
+static const char* const factory_names[] = {"single", "new", "pool"};
+
+struct configuration
+{
+  factory_kind factory;
+  bool memory;
+};
+
+static double
+now ()
+{
+  timeval tv;
+  gettimeofday (&tv, 0);
+  return static_cast<double> (tv.tv_sec) + tv.tv_usec / 1000000.0;
+}
+
+static sqlite::database*
+open (const configuration& c, const string& file)
+{
+  factory_ptr f;
+
+  switch (c.factory)
+  {
+  case factory_single:
+    f.reset (new sqlite::single_connection_factory);
+    break;
+  case factory_new:
+    f.reset (new sqlite::new_connection_factory);
+    break;
+  case factory_pool:
+    f.reset (new sqlite::connection_pool_factory);
+    break;
+  }
+
+  // Every connection to :memory: opens a separate database so use a
+  // named in-memory database with the shared cache instead.
+  //
+  string name (
+    c.memory ? "file:odb-benchmark?mode=memory&cache=shared" : file);
+  int flags (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+
+  if (c.memory)
+    flags |= SQLITE_OPEN_URI;
+  else
+  {
+    std::remove (file.c_str ());
+    std::remove ((file + "-journal").c_str ());
+  }
+
+#ifdef ODB_CXX11
+  return new sqlite::database (name, flags, true, "", std::move (f));
+#else
+  return new sqlite::database (name, flags, true, "", f);
+#endif
+}
+
+// Run all the operations on a new database and store the time each of
+// them took in seconds. Return the number of objects each operation
+// handled in counts.
+//
+static void
+run (const configuration& c,
+     const string& file,
+     size_t objects,
+     vector<double>& times,
+     vector<size_t>& counts)
+{
+  database_ptr db (open (c, file));
+
+  odb::connection_ptr keep;
+
+  {
+    odb::connection_ptr cn (db->connection ());
+
+    cn->execute ("PRAGMA foreign_keys=OFF");
+
+    transaction t (cn->begin ());
+    schema_catalog::create_schema (*db);
+    t.commit ();
+
+    cn->execute ("PRAGMA foreign_keys=ON");
+
+    // An in-memory database is destroyed once its last connection is
+    // closed and the new_ factory closes it after every transaction.
+    // The single_ factory keeps its only connection open by itself and
+    // hands it out to one holder at a time.
+    //
+    if (c.memory && c.factory != factory_single)
+      keep = cn;
+  }
+
+  context ctx (*db, objects);
+
+  times.resize (operation_count);
+  counts.resize (operation_count);
+
+  for (size_t i (0); i != operation_count; ++i)
+  {
+    double start (now ());
+    counts[i] = operations[i].function (ctx);
+    times[i] = now () - start;
+  }
+
+  keep.reset ();
+  db.reset ();
+
+  if (!c.memory)
+    std::remove (file.c_str ());
+}
+
+static void
+usage (ostream& os)
+{
+  os << "usage: driver [options]" << endl
+     << "--objects <n>   number of objects per operation, 1000 by default"
+     << endl
+     << "--repeat <n>    number of runs to take the best time of, 3 by "
+     << "default" << endl
+     << "--file <path>   on-disk database, odb-benchmark.db by default"
+     << endl
+     << "--output <path> write the JSON results to the file instead of "
+     << "stdout" << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+  size_t objects (1000);
+  size_t repeat (3);
+  string file ("odb-benchmark.db");
+  string output;
+
+  for (int i (1); i < argc; ++i)
+  {
+    string a (argv[i]);
+
+    if (a == "--help")
+    {
+      usage (cout);
+      return 0;
+    }
+
+    if (i + 1 == argc)
+    {
+      usage (cerr);
+      return 1;
+    }
+
+    if (a == "--objects")
+      objects = std::strtoul (argv[++i], 0, 10);
+    else if (a == "--repeat")
+      repeat = std::strtoul (argv[++i], 0, 10);
+    else if (a == "--file")
+      file = argv[++i];
+    else if (a == "--output")
+      output = argv[++i];
+    else
+    {
+      usage (cerr);
+      return 1;
+    }
+  }
+
+  if (objects == 0 || repeat == 0)
+  {
+    usage (cerr);
+    return 1;
+  }
+
+  try
+  {
+    ostringstream os;
+    os << "{" << endl
+       << "  \"odb_version\": " << ODB_VERSION << "," << endl
+       << "  \"sqlite_version\": \"" << sqlite3_libversion () << "\","
+       << endl
+       << "  \"objects\": " << objects << "," << endl
+       << "  \"repeat\": " << repeat << "," << endl
+       << "  \"results\": [";
+
+    bool first (true);
+
+    for (int f (factory_single); f <= factory_pool; ++f)
+    {
+      for (int m (1); m >= 0; --m)
+      {
+        configuration c;
+        c.factory = static_cast<factory_kind> (f);
+        c.memory = m != 0;
+
+        // Take the best time of all the runs.
+        //
+        vector<double> best;
+        vector<size_t> counts;
+
+        for (size_t r (0); r != repeat; ++r)
+        {
+          vector<double> times;
+          run (c, file, objects, times, counts);
+
+          if (r == 0)
+            best = times;
+          else
+          {
+            for (size_t i (0); i != operation_count; ++i)
+              if (times[i] < best[i])
+                best[i] = times[i];
+          }
+        }
+
+        for (size_t i (0); i != operation_count; ++i)
+        {
+          double ns (counts[i] != 0 ? best[i] * 1e9 / counts[i] : 0);
+
+          os << (first ? "" : ",") << endl
+             << "    {\"factory\": \"" << factory_names[f] << "\", "
+             << "\"storage\": \"" << (c.memory ? "memory" : "disk") << "\", "
+             << "\"operation\": \"" << operations[i].name << "\", "
+             << "\"count\": " << counts[i] << ", "
+             << "\"seconds\": " << best[i] << ", "
+             << "\"ns_per_object\": " << ns << "}";
+
+          first = false;
+        }
+      }
+    }
+
+    os << endl
+       << "  ]" << endl
+       << "}" << endl;
+
+    if (output.empty ())
+      cout << os.str ();
+    else
+    {
+      ofstream ofs (output.c_str ());
+      ofs << os.str ();
+
+      if (!ofs)
+      {
+        cerr << "error: unable to write " << output << endl;
+        return 1;
+      }
+    }
+  }
+  catch (const odb::exception& e)
+  {
+    cerr << e.what () << endl;
+    return 1;
+  }
+}
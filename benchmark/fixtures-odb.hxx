@@ -0,0 +1,1423 @@
+// file      : benchmark/fixtures-odb.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+// Database support code for the benchmark fixtures. Written by hand
+// after the ODB compiler output (see fixtures.hxx for the options) so
+// that the benchmark exercises the same runtime paths as an application
+// without requiring the compiler.
+//
+
+#ifndef BENCHMARK_FIXTURES_ODB_HXX
+#define BENCHMARK_FIXTURES_ODB_HXX
+
+#include <odb/version.hxx>
+
+#if (ODB_VERSION != 20200UL)
+#error ODB runtime version mismatch
+#endif
+
+#include <odb/pre.hxx>
+
+#include "fixtures.hxx"
+
+#include <memory>
+#include <cstddef>
+
+#include <odb/core.hxx>
+#include <odb/traits.hxx>
+#include <odb/callback.hxx>
+#include <odb/wrapper-traits.hxx>
+#include <odb/pointer-traits.hxx>
+#include <odb/container-traits.hxx>
+#include <odb/std-vector-traits.hxx>
+#include <odb/session.hxx>
+#include <odb/hash-session.hxx>
+#include <odb/cache-traits.hxx>
+#include <odb/prepared-query.hxx>
+#include <odb/result.hxx>
+#include <odb/simple-object-result.hxx>
+#include <odb/polymorphic-info.hxx>
+#include <odb/polymorphic-object-result.hxx>
+#include <odb/polymorphic-map.hxx>
+
+#include <odb/details/unused.hxx>
+#include <odb/details/shared-ptr.hxx>
+
+namespace odb
+{
+  // item
+  //
+  template <>
+  struct class_traits< ::item >
+  {
+    static const class_kind kind = class_object;
+  };
+
+  template <>
+  class access::object_traits< ::item >
+  {
+    public:
+    typedef ::item object_type;
+    typedef ::item* pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    static const bool polymorphic = false;
+
+    typedef long unsigned int id_type;
+
+    static const bool auto_id = true;
+
+    static const bool abstract = false;
+
+    static id_type
+    id (const object_type&);
+
+    typedef
+    odb::pointer_cache_traits<pointer_type, odb::session>
+    pointer_cache_traits;
+
+    typedef
+    odb::reference_cache_traits<object_type, odb::session>
+    reference_cache_traits;
+
+    static void
+    callback (database&, object_type&, callback_event);
+
+    static void
+    callback (database&, const object_type&, callback_event);
+  };
+
+  // bag
+  //
+  template <>
+  struct class_traits< ::bag >
+  {
+    static const class_kind kind = class_object;
+  };
+
+  template <>
+  class access::object_traits< ::bag >
+  {
+    public:
+    typedef ::bag object_type;
+    typedef ::bag* pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    static const bool polymorphic = false;
+
+    typedef long unsigned int id_type;
+
+    static const bool auto_id = true;
+
+    static const bool abstract = false;
+
+    static id_type
+    id (const object_type&);
+
+    typedef
+    odb::pointer_cache_traits<pointer_type, odb::session>
+    pointer_cache_traits;
+
+    typedef
+    odb::reference_cache_traits<object_type, odb::session>
+    reference_cache_traits;
+
+    static void
+    callback (database&, object_type&, callback_event);
+
+    static void
+    callback (database&, const object_type&, callback_event);
+  };
+
+  // shape
+  //
+  template <>
+  struct class_traits< ::shape >
+  {
+    static const class_kind kind = class_object;
+  };
+
+  template <>
+  class access::object_traits< ::shape >
+  {
+    public:
+    typedef ::shape object_type;
+    typedef ::shape* pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    static const bool polymorphic = true;
+
+    typedef ::shape root_type;
+    typedef ::std::string discriminator_type;
+    typedef polymorphic_map<object_type> map_type;
+    typedef polymorphic_concrete_info<object_type> info_type;
+
+    static const std::size_t depth = 1UL;
+
+    typedef long unsigned int id_type;
+
+    static const bool auto_id = true;
+
+    static const bool abstract = false;
+
+    static id_type
+    id (const object_type&);
+
+    typedef
+    odb::pointer_cache_traits<pointer_type, odb::session>
+    pointer_cache_traits;
+
+    typedef
+    odb::reference_cache_traits<object_type, odb::session>
+    reference_cache_traits;
+
+    static void
+    callback (database&, object_type&, callback_event);
+
+    static void
+    callback (database&, const object_type&, callback_event);
+  };
+
+  // circle
+  //
+  template <>
+  struct class_traits< ::circle >
+  {
+    static const class_kind kind = class_object;
+  };
+
+  template <>
+  class access::object_traits< ::circle >
+  {
+    public:
+    typedef ::circle object_type;
+    typedef ::circle* pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    static const bool polymorphic = true;
+
+    typedef ::shape root_type;
+    typedef ::shape base_type;
+    typedef object_traits<root_type>::discriminator_type discriminator_type;
+    typedef polymorphic_concrete_info<root_type> info_type;
+
+    static const std::size_t depth = 2UL;
+
+    typedef object_traits< ::shape >::id_type id_type;
+
+    static const bool auto_id = false;
+
+    static const bool abstract = false;
+
+    static id_type
+    id (const object_type&);
+
+    typedef
+    odb::pointer_cache_traits<
+      object_traits<root_type>::pointer_type,
+      odb::session >
+    pointer_cache_traits;
+
+    typedef
+    odb::reference_cache_traits<root_type, odb::session>
+    reference_cache_traits;
+
+    static void
+    callback (database&, object_type&, callback_event);
+
+    static void
+    callback (database&, const object_type&, callback_event);
+  };
+
+  // hashed_item
+  //
+  template <>
+  struct class_traits< ::hashed_item >
+  {
+    static const class_kind kind = class_object;
+  };
+
+  template <>
+  class access::object_traits< ::hashed_item >
+  {
+    public:
+    typedef ::hashed_item object_type;
+    typedef ::hashed_item* pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    static const bool polymorphic = false;
+
+    typedef long unsigned int id_type;
+
+    static const bool auto_id = true;
+
+    static const bool abstract = false;
+
+    static id_type
+    id (const object_type&);
+
+    typedef
+    odb::pointer_cache_traits<pointer_type, odb::hash_session>
+    pointer_cache_traits;
+
+    typedef
+    odb::reference_cache_traits<object_type, odb::hash_session>
+    reference_cache_traits;
+
+    static void
+    callback (database&, object_type&, callback_event);
+
+    static void
+    callback (database&, const object_type&, callback_event);
+  };
+}
+
+#include <odb/details/buffer.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/binding.hxx>
+#include <odb/sqlite/sqlite-types.hxx>
+#include <odb/sqlite/query.hxx>
+
+namespace odb
+{
+  // item
+  //
+  template <typename A>
+  struct query_columns< ::item, id_sqlite, A >
+  {
+    // id
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        long unsigned int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    id_type_;
+
+    static const id_type_ id;
+
+    // num
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    num_type_;
+
+    static const num_type_ num;
+
+    // name
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        ::std::string,
+        sqlite::id_text >::query_type,
+      sqlite::id_text >
+    name_type_;
+
+    static const name_type_ name;
+
+    // value
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        double,
+        sqlite::id_real >::query_type,
+      sqlite::id_real >
+    value_type_;
+
+    static const value_type_ value;
+  };
+
+  template <typename A>
+  const typename query_columns< ::item, id_sqlite, A >::id_type_
+  query_columns< ::item, id_sqlite, A >::
+  id (A::table_name, "\"id\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::item, id_sqlite, A >::num_type_
+  query_columns< ::item, id_sqlite, A >::
+  num (A::table_name, "\"num\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::item, id_sqlite, A >::name_type_
+  query_columns< ::item, id_sqlite, A >::
+  name (A::table_name, "\"name\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::item, id_sqlite, A >::value_type_
+  query_columns< ::item, id_sqlite, A >::
+  value (A::table_name, "\"value\"", 0);
+
+  template <typename A>
+  struct pointer_query_columns< ::item, id_sqlite, A >:
+    query_columns< ::item, id_sqlite, A >
+  {
+  };
+
+  template <>
+  class access::object_traits_impl< ::item, id_sqlite >:
+    public access::object_traits< ::item >
+  {
+    public:
+    struct id_image_type
+    {
+      long long id_value;
+      bool id_null;
+
+      std::size_t version;
+    };
+
+    struct image_type
+    {
+      // id
+      //
+      long long id_value;
+      bool id_null;
+
+      // num
+      //
+      long long num_value;
+      bool num_null;
+
+      // name
+      //
+      details::buffer name_value;
+      std::size_t name_size;
+      bool name_null;
+
+      // value
+      //
+      double value_value;
+      bool value_null;
+
+      std::size_t version;
+    };
+
+    using object_traits<object_type>::id;
+
+    static id_type
+    id (const image_type&);
+
+    static bool
+    grow (image_type&,
+          bool*);
+
+    static void
+    bind (sqlite::bind*,
+          image_type&,
+          sqlite::statement_kind);
+
+    static void
+    bind (sqlite::bind*, id_image_type&);
+
+    static bool
+    init (image_type&,
+          const object_type&,
+          sqlite::statement_kind);
+
+    static void
+    init (object_type&,
+          const image_type&,
+          database*);
+
+    static void
+    init (id_image_type&, const id_type&);
+
+    typedef sqlite::object_statements<object_type> statements_type;
+
+    typedef sqlite::query_base query_base_type;
+
+    struct container_statement_cache_type;
+
+    static const std::size_t column_count = 4UL;
+    static const std::size_t id_column_count = 1UL;
+    static const std::size_t inverse_column_count = 0UL;
+    static const std::size_t readonly_column_count = 0UL;
+    static const std::size_t managed_optimistic_column_count = 0UL;
+
+    static const std::size_t batch = 1000UL;
+
+    static const char persist_statement[];
+    static const char find_statement[];
+    static const char update_statement[];
+    static const char erase_statement[];
+    static const char query_statement[];
+    static const char erase_query_statement[];
+
+    static const char table_name[];
+
+    static void
+    persist (database&, object_type&);
+
+    static std::size_t
+    persist (database&,
+             object_type**,
+             std::size_t,
+             multiple_exceptions&,
+             bool);
+
+    static pointer_type
+    find (database&, const id_type&);
+
+    static bool
+    find (database&, const id_type&, object_type&);
+
+    static bool
+    reload (database&, object_type&);
+
+    static void
+    update (database&, const object_type&);
+
+    static std::size_t
+    update (database&,
+            const object_type**,
+            std::size_t,
+            multiple_exceptions&,
+            bool);
+
+    static void
+    erase (database&, const id_type&);
+
+    static std::size_t
+    erase (database&,
+           const id_type*,
+           std::size_t,
+           multiple_exceptions&,
+           bool);
+
+    static void
+    erase (database&, const object_type&);
+
+    static result<object_type>
+    query (database&, const query_base_type&);
+
+    static unsigned long long
+    erase_query (database&, const query_base_type&);
+
+    static odb::details::shared_ptr<prepared_query_impl>
+    prepare_query (connection&, const char*, const query_base_type&);
+
+    static odb::details::shared_ptr<result_impl>
+    execute_query (prepared_query_impl&);
+
+    public:
+    static bool
+    find_ (statements_type&, const id_type*);
+
+    static void
+    load_ (statements_type&, object_type&);
+  };
+
+  template <>
+  class access::object_traits_impl< ::item, id_common >:
+    public access::object_traits_impl< ::item, id_sqlite >
+  {
+  };
+
+  // bag
+  //
+  template <typename A>
+  struct query_columns< ::bag, id_sqlite, A >
+  {
+    // id
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        long unsigned int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    id_type_;
+
+    static const id_type_ id;
+
+    // name
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        ::std::string,
+        sqlite::id_text >::query_type,
+      sqlite::id_text >
+    name_type_;
+
+    static const name_type_ name;
+  };
+
+  template <typename A>
+  const typename query_columns< ::bag, id_sqlite, A >::id_type_
+  query_columns< ::bag, id_sqlite, A >::
+  id (A::table_name, "\"id\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::bag, id_sqlite, A >::name_type_
+  query_columns< ::bag, id_sqlite, A >::
+  name (A::table_name, "\"name\"", 0);
+
+  template <typename A>
+  struct pointer_query_columns< ::bag, id_sqlite, A >:
+    query_columns< ::bag, id_sqlite, A >
+  {
+  };
+
+  template <>
+  class access::object_traits_impl< ::bag, id_sqlite >:
+    public access::object_traits< ::bag >
+  {
+    public:
+    struct id_image_type
+    {
+      long long id_value;
+      bool id_null;
+
+      std::size_t version;
+    };
+
+    struct image_type
+    {
+      // id
+      //
+      long long id_value;
+      bool id_null;
+
+      // name
+      //
+      details::buffer name_value;
+      std::size_t name_size;
+      bool name_null;
+
+      std::size_t version;
+    };
+
+    // tags
+    //
+    struct tags_traits
+    {
+      static const std::size_t id_column_count = 1UL;
+      static const std::size_t data_column_count = 3UL;
+
+      static const char insert_statement[];
+      static const char select_statement[];
+      static const char delete_statement[];
+
+      typedef ::std::vector< ::std::string > container_type;
+      typedef
+      odb::access::container_traits<container_type>
+      container_traits_type;
+      typedef container_traits_type::index_type index_type;
+      typedef container_traits_type::value_type value_type;
+
+      typedef ordered_functions<index_type, value_type> functions_type;
+      typedef sqlite::container_statements< tags_traits > statements_type;
+
+      struct data_image_type
+      {
+        // index
+        //
+        long long index_value;
+        bool index_null;
+
+        // value
+        //
+        details::buffer value_value;
+        std::size_t value_size;
+        bool value_null;
+
+        std::size_t version;
+      };
+
+      static void
+      bind (sqlite::bind*,
+            const sqlite::bind* id,
+            std::size_t id_size,
+            data_image_type&);
+
+      static void
+      grow (data_image_type&,
+            bool*);
+
+      static void
+      init (data_image_type&,
+            index_type*,
+            const value_type&);
+
+      static void
+      init (index_type&,
+            value_type&,
+            const data_image_type&,
+            database*);
+
+      static void
+      insert (index_type, const value_type&, void*);
+
+      static bool
+      select (index_type&, value_type&, void*);
+
+      static void
+      delete_ (void*);
+
+      static void
+      persist (const container_type&,
+               statements_type&);
+
+      static void
+      load (container_type&,
+            statements_type&);
+
+      static void
+      update (const container_type&,
+              statements_type&);
+
+      static void
+      erase (statements_type&);
+    };
+
+    using object_traits<object_type>::id;
+
+    static id_type
+    id (const image_type&);
+
+    static bool
+    grow (image_type&,
+          bool*);
+
+    static void
+    bind (sqlite::bind*,
+          image_type&,
+          sqlite::statement_kind);
+
+    static void
+    bind (sqlite::bind*, id_image_type&);
+
+    static bool
+    init (image_type&,
+          const object_type&,
+          sqlite::statement_kind);
+
+    static void
+    init (object_type&,
+          const image_type&,
+          database*);
+
+    static void
+    init (id_image_type&, const id_type&);
+
+    typedef sqlite::object_statements<object_type> statements_type;
+
+    typedef sqlite::query_base query_base_type;
+
+    struct container_statement_cache_type;
+
+    static const std::size_t column_count = 2UL;
+    static const std::size_t id_column_count = 1UL;
+    static const std::size_t inverse_column_count = 0UL;
+    static const std::size_t readonly_column_count = 0UL;
+    static const std::size_t managed_optimistic_column_count = 0UL;
+
+    static const char persist_statement[];
+    static const char find_statement[];
+    static const char update_statement[];
+    static const char erase_statement[];
+    static const char query_statement[];
+    static const char erase_query_statement[];
+
+    static const char table_name[];
+
+    static void
+    persist (database&, object_type&);
+
+    static pointer_type
+    find (database&, const id_type&);
+
+    static bool
+    find (database&, const id_type&, object_type&);
+
+    static bool
+    reload (database&, object_type&);
+
+    static void
+    update (database&, const object_type&);
+
+    static void
+    erase (database&, const id_type&);
+
+    static void
+    erase (database&, const object_type&);
+
+    static result<object_type>
+    query (database&, const query_base_type&);
+
+    static unsigned long long
+    erase_query (database&, const query_base_type&);
+
+    static odb::details::shared_ptr<prepared_query_impl>
+    prepare_query (connection&, const char*, const query_base_type&);
+
+    static odb::details::shared_ptr<result_impl>
+    execute_query (prepared_query_impl&);
+
+    public:
+    static bool
+    find_ (statements_type&, const id_type*);
+
+    static void
+    load_ (statements_type&, object_type&);
+  };
+
+  template <>
+  class access::object_traits_impl< ::bag, id_common >:
+    public access::object_traits_impl< ::bag, id_sqlite >
+  {
+  };
+
+  // shape
+  //
+  template <typename A>
+  struct query_columns< ::shape, id_sqlite, A >
+  {
+    // id
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        long unsigned int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    id_type_;
+
+    static const id_type_ id;
+
+    // typeid_
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        ::std::string,
+        sqlite::id_text >::query_type,
+      sqlite::id_text >
+    typeid__type_;
+
+    static const typeid__type_ typeid_;
+
+    // name
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        ::std::string,
+        sqlite::id_text >::query_type,
+      sqlite::id_text >
+    name_type_;
+
+    static const name_type_ name;
+  };
+
+  template <typename A>
+  const typename query_columns< ::shape, id_sqlite, A >::id_type_
+  query_columns< ::shape, id_sqlite, A >::
+  id (A::table_name, "\"id\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::shape, id_sqlite, A >::typeid__type_
+  query_columns< ::shape, id_sqlite, A >::
+  typeid_ (A::table_name, "\"typeid\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::shape, id_sqlite, A >::name_type_
+  query_columns< ::shape, id_sqlite, A >::
+  name (A::table_name, "\"name\"", 0);
+
+  template <typename A>
+  struct pointer_query_columns< ::shape, id_sqlite, A >:
+    query_columns< ::shape, id_sqlite, A >
+  {
+  };
+
+  template <>
+  class access::object_traits_impl< ::shape, id_sqlite >:
+    public access::object_traits< ::shape >
+  {
+    public:
+    typedef polymorphic_entry<object_type, id_sqlite> entry_type;
+    typedef object_traits_impl<root_type, id_sqlite> root_traits;
+
+    static map_type* map;
+    static const info_type info;
+
+    struct id_image_type
+    {
+      long long id_value;
+      bool id_null;
+
+      std::size_t version;
+    };
+
+    struct discriminator_image_type
+    {
+      details::buffer discriminator_value;
+      std::size_t discriminator_size;
+      bool discriminator_null;
+
+      std::size_t version;
+    };
+
+    struct image_type
+    {
+      // id
+      //
+      long long id_value;
+      bool id_null;
+
+      // typeid_
+      //
+      details::buffer typeid_value;
+      std::size_t typeid_size;
+      bool typeid_null;
+
+      // name
+      //
+      details::buffer name_value;
+      std::size_t name_size;
+      bool name_null;
+
+      std::size_t version;
+    };
+
+    using object_traits<object_type>::id;
+
+    static id_type
+    id (const image_type&);
+
+    static discriminator_type
+    discriminator (const image_type&);
+
+    static bool
+    grow (image_type&,
+          bool*);
+
+    static void
+    bind (sqlite::bind*,
+          image_type&,
+          sqlite::statement_kind);
+
+    static void
+    bind (sqlite::bind*, id_image_type&);
+
+    static void
+    bind (sqlite::bind*, discriminator_image_type&);
+
+    static bool
+    grow (discriminator_image_type&,
+          bool*);
+
+    static bool
+    init (image_type&,
+          const object_type&,
+          sqlite::statement_kind);
+
+    static void
+    init (object_type&,
+          const image_type&,
+          database*);
+
+    static void
+    init (id_image_type&, const id_type&);
+
+    typedef
+    sqlite::polymorphic_root_object_statements<object_type>
+    statements_type;
+
+    typedef sqlite::query_base query_base_type;
+
+    struct container_statement_cache_type;
+
+    static const std::size_t column_count = 3UL;
+    static const std::size_t discriminator_column_count = 1UL;
+    static const std::size_t id_column_count = 1UL;
+    static const std::size_t inverse_column_count = 0UL;
+    static const std::size_t readonly_column_count = 1UL;
+    static const std::size_t managed_optimistic_column_count = 0UL;
+
+    static const char persist_statement[];
+    static const char find_statement[];
+    static const char find_discriminator_statement[];
+    static const char update_statement[];
+    static const char erase_statement[];
+    static const char query_statement[];
+    static const char erase_query_statement[];
+
+    static const char table_name[];
+
+    static void
+    persist (database&, object_type&, bool top = true, bool dyn = true);
+
+    static pointer_type
+    find (database&, const id_type&);
+
+    static bool
+    find (database&, const id_type&, object_type&, bool dyn = true);
+
+    static bool
+    reload (database&, object_type&, bool dyn = true);
+
+    static void
+    update (database&, const object_type&, bool top = true, bool dyn = true);
+
+    static void
+    erase (database&, const id_type&, bool top = true, bool dyn = true);
+
+    static void
+    erase (database&, const object_type&, bool top = true, bool dyn = true);
+
+    static result<object_type>
+    query (database&, const query_base_type&);
+
+    static unsigned long long
+    erase_query (database&, const query_base_type&);
+
+    static odb::details::shared_ptr<prepared_query_impl>
+    prepare_query (connection&, const char*, const query_base_type&);
+
+    static odb::details::shared_ptr<result_impl>
+    execute_query (prepared_query_impl&);
+
+    public:
+    static bool
+    find_ (statements_type&, const id_type*);
+
+    static void
+    load_ (statements_type&, object_type&);
+
+    static void
+    discriminator_ (statements_type&,
+                    const id_type&,
+                    discriminator_type*);
+  };
+
+  template <>
+  class access::object_traits_impl< ::shape, id_common >:
+    public access::object_traits_impl< ::shape, id_sqlite >
+  {
+  };
+
+  // circle
+  //
+  template <typename A>
+  struct query_columns< ::circle, id_sqlite, A >:
+    query_columns< ::shape, id_sqlite, typename A::base_traits >
+  {
+    // shape
+    //
+    typedef query_columns< ::shape, id_sqlite, typename A::base_traits >
+    shape;
+
+    // id
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        long unsigned int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    id_type_;
+
+    static const id_type_ id;
+
+    // radius
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        double,
+        sqlite::id_real >::query_type,
+      sqlite::id_real >
+    radius_type_;
+
+    static const radius_type_ radius;
+  };
+
+  template <typename A>
+  const typename query_columns< ::circle, id_sqlite, A >::id_type_
+  query_columns< ::circle, id_sqlite, A >::
+  id (A::table_name, "\"id\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::circle, id_sqlite, A >::radius_type_
+  query_columns< ::circle, id_sqlite, A >::
+  radius (A::table_name, "\"radius\"", 0);
+
+  template <typename A>
+  struct pointer_query_columns< ::circle, id_sqlite, A >:
+    query_columns< ::circle, id_sqlite, A >
+  {
+  };
+
+  template <>
+  class access::object_traits_impl< ::circle, id_sqlite >:
+    public access::object_traits< ::circle >
+  {
+    public:
+    typedef polymorphic_entry<object_type, id_sqlite> entry_type;
+    typedef object_traits_impl<root_type, id_sqlite> root_traits;
+    typedef object_traits_impl<base_type, id_sqlite> base_traits;
+
+    typedef root_traits::id_image_type id_image_type;
+
+    static const info_type info;
+
+    struct image_type
+    {
+      base_traits::image_type* base;
+
+      // radius
+      //
+      double radius_value;
+      bool radius_null;
+
+      std::size_t version;
+    };
+
+    using object_traits<object_type>::id;
+
+    static bool
+    grow (image_type&,
+          bool*,
+          std::size_t = depth);
+
+    static void
+    bind (sqlite::bind*,
+          const sqlite::bind* id,
+          std::size_t id_size,
+          image_type&,
+          sqlite::statement_kind);
+
+    static void
+    bind (sqlite::bind*, id_image_type&);
+
+    static bool
+    init (image_type&,
+          const object_type&,
+          sqlite::statement_kind);
+
+    static void
+    init (object_type&,
+          const image_type&,
+          database*,
+          std::size_t = depth);
+
+    static bool
+    check_version (const std::size_t*, const image_type&);
+
+    static void
+    update_version (std::size_t*, const image_type&, sqlite::binding*);
+
+    typedef
+    sqlite::polymorphic_derived_object_statements<object_type>
+    statements_type;
+
+    typedef
+    sqlite::polymorphic_root_object_statements<root_type>
+    root_statements_type;
+
+    typedef sqlite::query_base query_base_type;
+
+    struct container_statement_cache_type;
+
+    static const std::size_t column_count = 2UL;
+    static const std::size_t id_column_count = 1UL;
+    static const std::size_t inverse_column_count = 0UL;
+    static const std::size_t readonly_column_count = 0UL;
+    static const std::size_t managed_optimistic_column_count = 0UL;
+
+    static const char persist_statement[];
+    static const char* const find_statements[depth];
+    static const std::size_t find_column_counts[depth];
+    static const char update_statement[];
+    static const char erase_statement[];
+    static const char query_statement[];
+    static const char erase_query_statement[];
+
+    static const char table_name[];
+
+    static void
+    persist (database&, object_type&, bool top = true, bool dyn = true);
+
+    static pointer_type
+    find (database&, const id_type&);
+
+    static bool
+    find (database&, const id_type&, object_type&, bool dyn = true);
+
+    static bool
+    reload (database&, object_type&, bool dyn = true);
+
+    static void
+    update (database&, const object_type&, bool top = true, bool dyn = true);
+
+    static void
+    erase (database&, const id_type&, bool top = true, bool dyn = true);
+
+    static void
+    erase (database&, const object_type&, bool top = true, bool dyn = true);
+
+    static result<object_type>
+    query (database&, const query_base_type&);
+
+    static unsigned long long
+    erase_query (database&, const query_base_type&);
+
+    static odb::details::shared_ptr<prepared_query_impl>
+    prepare_query (connection&, const char*, const query_base_type&);
+
+    static odb::details::shared_ptr<result_impl>
+    execute_query (prepared_query_impl&);
+
+    public:
+    static bool
+    find_ (statements_type&, const id_type*, std::size_t = depth);
+
+    static void
+    load_ (statements_type&, object_type&, std::size_t = depth);
+
+    static void
+    load_ (database&, root_type&, std::size_t);
+  };
+
+  template <>
+  class access::object_traits_impl< ::circle, id_common >:
+    public access::object_traits_impl< ::circle, id_sqlite >
+  {
+  };
+
+  // hashed_item
+  //
+  template <typename A>
+  struct query_columns< ::hashed_item, id_sqlite, A >
+  {
+    // id
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        long unsigned int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    id_type_;
+
+    static const id_type_ id;
+
+    // num
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        int,
+        sqlite::id_integer >::query_type,
+      sqlite::id_integer >
+    num_type_;
+
+    static const num_type_ num;
+
+    // name
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        ::std::string,
+        sqlite::id_text >::query_type,
+      sqlite::id_text >
+    name_type_;
+
+    static const name_type_ name;
+
+    // value
+    //
+    typedef
+    sqlite::query_column<
+      sqlite::value_traits<
+        double,
+        sqlite::id_real >::query_type,
+      sqlite::id_real >
+    value_type_;
+
+    static const value_type_ value;
+  };
+
+  template <typename A>
+  const typename query_columns< ::hashed_item, id_sqlite, A >::id_type_
+  query_columns< ::hashed_item, id_sqlite, A >::
+  id (A::table_name, "\"id\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::hashed_item, id_sqlite, A >::num_type_
+  query_columns< ::hashed_item, id_sqlite, A >::
+  num (A::table_name, "\"num\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::hashed_item, id_sqlite, A >::name_type_
+  query_columns< ::hashed_item, id_sqlite, A >::
+  name (A::table_name, "\"name\"", 0);
+
+  template <typename A>
+  const typename query_columns< ::hashed_item, id_sqlite, A >::value_type_
+  query_columns< ::hashed_item, id_sqlite, A >::
+  value (A::table_name, "\"value\"", 0);
+
+  template <typename A>
+  struct pointer_query_columns< ::hashed_item, id_sqlite, A >:
+    query_columns< ::hashed_item, id_sqlite, A >
+  {
+  };
+
+  template <>
+  class access::object_traits_impl< ::hashed_item, id_sqlite >:
+    public access::object_traits< ::hashed_item >
+  {
+    public:
+    struct id_image_type
+    {
+      long long id_value;
+      bool id_null;
+
+      std::size_t version;
+    };
+
+    struct image_type
+    {
+      // id
+      //
+      long long id_value;
+      bool id_null;
+
+      // num
+      //
+      long long num_value;
+      bool num_null;
+
+      // name
+      //
+      details::buffer name_value;
+      std::size_t name_size;
+      bool name_null;
+
+      // value
+      //
+      double value_value;
+      bool value_null;
+
+      std::size_t version;
+    };
+
+    using object_traits<object_type>::id;
+
+    static id_type
+    id (const image_type&);
+
+    static bool
+    grow (image_type&,
+          bool*);
+
+    static void
+    bind (sqlite::bind*,
+          image_type&,
+          sqlite::statement_kind);
+
+    static void
+    bind (sqlite::bind*, id_image_type&);
+
+    static bool
+    init (image_type&,
+          const object_type&,
+          sqlite::statement_kind);
+
+    static void
+    init (object_type&,
+          const image_type&,
+          database*);
+
+    static void
+    init (id_image_type&, const id_type&);
+
+    typedef sqlite::object_statements<object_type> statements_type;
+
+    typedef sqlite::query_base query_base_type;
+
+    struct container_statement_cache_type;
+
+    static const std::size_t column_count = 4UL;
+    static const std::size_t id_column_count = 1UL;
+    static const std::size_t inverse_column_count = 0UL;
+    static const std::size_t readonly_column_count = 0UL;
+    static const std::size_t managed_optimistic_column_count = 0UL;
+
+    static const char persist_statement[];
+    static const char find_statement[];
+    static const char update_statement[];
+    static const char erase_statement[];
+    static const char query_statement[];
+    static const char erase_query_statement[];
+
+    static const char table_name[];
+
+    static void
+    persist (database&, object_type&);
+
+    static pointer_type
+    find (database&, const id_type&);
+
+    static bool
+    find (database&, const id_type&, object_type&);
+
+    static bool
+    reload (database&, object_type&);
+
+    static void
+    update (database&, const object_type&);
+
+    static void
+    erase (database&, const id_type&);
+
+    static void
+    erase (database&, const object_type&);
+
+    static result<object_type>
+    query (database&, const query_base_type&);
+
+    static unsigned long long
+    erase_query (database&, const query_base_type&);
+
+    static odb::details::shared_ptr<prepared_query_impl>
+    prepare_query (connection&, const char*, const query_base_type&);
+
+    static odb::details::shared_ptr<result_impl>
+    execute_query (prepared_query_impl&);
+
+    public:
+    static bool
+    find_ (statements_type&, const id_type*);
+
+    static void
+    load_ (statements_type&, object_type&);
+  };
+
+  template <>
+  class access::object_traits_impl< ::hashed_item, id_common >:
+    public access::object_traits_impl< ::hashed_item, id_sqlite >
+  {
+  };
+}
+
+#include "fixtures-odb.ixx"
+
+#include <odb/post.hxx>
+
+#endif // BENCHMARK_FIXTURES_ODB_HXX
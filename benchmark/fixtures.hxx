@@ -0,0 +1,119 @@
+// file      : benchmark/fixtures.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef BENCHMARK_FIXTURES_HXX
+#define BENCHMARK_FIXTURES_HXX
+
+#include <string>
+#include <vector>
+
+#include <odb/core.hxx>
+
+// Persistent classes used by the benchmark. The database support code
+// for them is written by hand in fixtures-odb.?xx and mirrors what the
+// ODB compiler generates for SQLite with the following options:
+//
+// --database sqlite --generate-query --generate-prepared --generate-session
+// --generate-schema --schema-format embedded
+//
+// The pragmas below document the mapping and are not otherwise used.
+//
+
+// Simple object with bulk operations.
+//
+#pragma db object bulk(1000)
+class item
+{
+public:
+  item (): id (0), num (0), value (0) {}
+
+  item (int n, const std::string& s, double v)
+      : id (0), num (n), name (s), value (v)
+  {
+  }
+
+  #pragma db id auto
+  unsigned long id;
+
+  #pragma db index
+  int num;
+
+  std::string name;
+  double value;
+};
+
+// Object with a container.
+//
+#pragma db object
+class bag
+{
+public:
+  bag (): id (0) {}
+
+  explicit
+  bag (const std::string& s): id (0), name (s) {}
+
+  #pragma db id auto
+  unsigned long id;
+
+  std::string name;
+  std::vector<std::string> tags;
+};
+
+// Polymorphic hierarchy.
+//
+#pragma db object polymorphic
+class shape
+{
+public:
+  shape (): id (0) {}
+
+  explicit
+  shape (const std::string& s): id (0), name (s) {}
+
+  virtual
+  ~shape () {}
+
+  #pragma db id auto
+  unsigned long id;
+
+  std::string name;
+};
+
+#pragma db object
+class circle: public shape
+{
+public:
+  circle (): radius (0) {}
+  circle (const std::string& s, double r): shape (s), radius (r) {}
+
+  double radius;
+};
+
+// Same as item, without bulk operations, but cached in odb::hash_session
+// rather than in odb::session, as if generated with --session-type
+// odb::hash_session.
+//
+#pragma db object
+class hashed_item
+{
+public:
+  hashed_item (): id (0), num (0), value (0) {}
+
+  hashed_item (int n, const std::string& s, double v)
+      : id (0), num (n), name (s), value (v)
+  {
+  }
+
+  #pragma db id auto
+  unsigned long id;
+
+  #pragma db index
+  int num;
+
+  std::string name;
+  double value;
+};
+
+#endif // BENCHMARK_FIXTURES_HXX
@@ -0,0 +1,395 @@
+// file      : odb/bounded-session.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_BOUNDED_SESSION_HXX
+#define ODB_BOUNDED_SESSION_HXX
+
+#include <odb/pre.hxx>
+
+#include <map>
+#include <list>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/traits.hxx>
+#include <odb/forward.hxx>
+#include <odb/pointer-traits.hxx>
+
+#include <odb/details/tls.hxx>
+#include <odb/details/atomic.hxx>
+#include <odb/details/shared-ptr.hxx>
+
+namespace odb
+{
+  // Estimated amount of memory occupied by an object as used by
+  // bounded_session to enforce its byte budget. Specialize this template
+  // for object types that own a significant amount of dynamically
+  // allocated memory (strings, containers, etc).
+  //
+  template <typename T>
+  struct object_size
+  {
+    static std::size_t
+    size (const T&) {return sizeof (T);}
+  };
+
+  // Session with a bounded object cache. When the number of cached
+  // objects or their estimated total size exceeds the budget, objects
+  // are evicted in the least recently used (lru) or in the CLOCK (clock)
+  // order. CLOCK approximates LRU but a cache hit only sets a flag
+  // instead of reordering the cache.
+  //
+  // An object that is referenced outside the session (that is, its
+  // shared object pointer's use count is greater than one) as well as an
+  // object that is being loaded or persisted is never evicted, so the
+  // session may temporarily exceed its budget. Since the session does
+  // not own objects referenced with raw pointers, it cannot tell whether
+  // such objects are still in use and evicts them like any other. Once
+  // evicted, an object is loaded anew the next time it is requested.
+  //
+  // This session type is selected with the --session-type ODB compiler
+  // option (or the session pragma). The interface mirrors odb::session
+  // except that the low-level map() access is not provided.
+  //
+  class bounded_session
+  {
+  public:
+    typedef odb::database database_type;
+
+    enum eviction_policy
+    {
+      lru,
+      clock
+    };
+
+    struct statistics_type
+    {
+      std::size_t hits;
+      std::size_t misses;
+      std::size_t evictions;
+      std::size_t size;  // Number of cached objects.
+      std::size_t bytes; // Estimated size of cached objects.
+    };
+
+    // Zero max_objects or max_bytes means no limit on the number of
+    // objects or their size, respectively. If the make_current argument
+    // is true, then set the current thread's session to this session. If
+    // another session is already in effect, throw the already_in_session
+    // exception.
+    //
+    bounded_session (std::size_t max_objects,
+                     std::size_t max_bytes = 0,
+                     eviction_policy = lru,
+                     bool make_current = true);
+
+    // Reset the current thread's session if it is this session.
+    //
+    ~bounded_session ();
+
+    statistics_type
+    statistics () const;
+
+    // Current session.
+    //
+  public:
+    static bool
+    has_current () {return current_pointer () != 0;}
+
+    // Get current thread's session. Throw if no session is in effect.
+    //
+    static bounded_session&
+    current ();
+
+    static void
+    current (bounded_session& s) {current_pointer (&s);}
+
+    static void
+    reset_current () {current_pointer (0);}
+
+    static bounded_session*
+    current_pointer ();
+
+    static void
+    current_pointer (bounded_session*);
+
+    // Copying or assignment of sessions is not supported.
+    //
+  private:
+    bounded_session (const bounded_session&);
+    bounded_session& operator= (const bounded_session&);
+
+  protected:
+    struct entry_base;
+    typedef std::list<entry_base*> entry_list;
+
+    struct entry_base
+    {
+      entry_base (): size (0), pinned (true), used (false) {}
+
+      virtual
+      ~entry_base () {}
+
+      // Return true if the object is referenced outside the session.
+      //
+      virtual bool
+      referenced () const = 0;
+
+      // Remove the entry from its object map.
+      //
+      virtual void
+      unlink () = 0;
+
+      std::size_t size;
+      bool pinned; // Being loaded or persisted.
+      bool used;   // CLOCK reference flag.
+      entry_list::iterator pos;
+    };
+
+    struct object_map_base: details::shared_base
+    {
+      virtual
+      ~object_map_base () {}
+    };
+
+    template <typename T>
+    struct entry;
+
+    template <typename T>
+    struct object_map: object_map_base,
+                       std::map<typename object_traits<T>::id_type,
+                                entry<T>*>
+    {
+      object_map (bounded_session& s): session (s) {}
+
+      bounded_session& session;
+    };
+
+    template <typename T>
+    struct entry: entry_base
+    {
+      typedef typename object_traits<T>::id_type id_type;
+      typedef typename object_traits<T>::pointer_type pointer_type;
+
+      entry (object_map<T>& m, const id_type& i, const pointer_type& o)
+          : map (m), id (i), obj (o) {}
+
+      virtual bool
+      referenced () const;
+
+      virtual void
+      unlink () {map.erase (id);}
+
+      // Recalculate the object size.
+      //
+      void
+      measure ();
+
+      object_map<T>& map;
+      id_type id;
+      pointer_type obj;
+    };
+
+    // Object cache.
+    //
+  public:
+    template <typename T>
+    struct cache_position;
+
+    template <typename T>
+    cache_position<T>
+    cache_insert (database_type&,
+                  const typename object_traits<T>::id_type&,
+                  const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    typename object_traits<T>::pointer_type
+    cache_find (database_type&, const typename object_traits<T>::id_type&);
+
+    template <typename T>
+    void
+    cache_erase (const cache_position<T>&);
+
+    template <typename T>
+    void
+    cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+    // Static cache API as expected by the rest of ODB.
+    //
+  public:
+    // Position in the cache of the inserted element. Since the object
+    // can be erased by the time the position is used, it is the object
+    // id rather than the entry.
+    //
+    template <typename T>
+    struct cache_position
+    {
+      typedef object_map<T> map;
+      typedef typename object_traits<T>::id_type id_type;
+
+      cache_position (): map_ (0) {}
+      cache_position (map& m, const id_type& id): map_ (&m), id_ (id) {}
+
+      map* map_;
+      id_type id_;
+    };
+
+    template <typename T>
+    static cache_position<T>
+    _cache_insert (database_type&,
+                   const typename object_traits<T>::id_type&,
+                   const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    static typename object_traits<T>::pointer_type
+    _cache_find (database_type&, const typename object_traits<T>::id_type&);
+
+    template <typename T>
+    static void
+    _cache_erase (const cache_position<T>&);
+
+    // Notifications. These are called after per-object callbacks for
+    // post_{persist, load, update, erase} events. Once the object is
+    // persisted or loaded, it can be evicted.
+    //
+    template <typename T>
+    static void
+    _cache_persist (const cache_position<T>& p) {_cache_release (p);}
+
+    template <typename T>
+    static void
+    _cache_load (const cache_position<T>& p) {_cache_release (p);}
+
+    template <typename T>
+    static void
+    _cache_update (database_type&, const T&);
+
+    template <typename T>
+    static void
+    _cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+  protected:
+    typedef std::vector<details::shared_ptr<object_map_base> > type_map;
+
+    struct database_entry
+    {
+      database_type* db;
+      type_map types;
+    };
+
+    typedef std::vector<database_entry> database_map;
+
+    template <typename T>
+    static void
+    _cache_release (const cache_position<T>&);
+
+    template <typename T>
+    void
+    cache_release (const cache_position<T>&);
+
+    template <typename T>
+    void
+    cache_update (database_type&, const T&);
+
+    // Return this type's index in type_map. Indexes are allocated on
+    // first use and are the same for all the sessions.
+    //
+    template <typename T>
+    static std::size_t
+    type_index ();
+
+    template <typename T>
+    object_map<T>&
+    map (database_type&);
+
+    template <typename T>
+    object_map<T>*
+    find_map (database_type&) const;
+
+    bool
+    over_budget () const;
+
+    void
+    link (entry_base&);
+
+    // Remove the entry from the cache and delete it. Return the
+    // following position in the list.
+    //
+    entry_list::iterator
+    erase (entry_list::iterator);
+
+    // Evict objects until the cache is within its budget or there is
+    // nothing left that can be evicted.
+    //
+    void
+    evict ();
+
+    static bool
+    evictable (const entry_base& e)
+    {
+      return !e.pinned && !e.referenced ();
+    }
+
+    // These are templates only to allow the definition in the header.
+    //
+    template <typename S>
+    struct current_
+    {
+      static ODB_TLS_POINTER (S) value;
+    };
+
+    template <typename S>
+    struct type_index_
+    {
+      static details::atomic_count next;
+    };
+
+  protected:
+    std::size_t max_objects_;
+    std::size_t max_bytes_;
+    eviction_policy policy_;
+
+    database_map db_map_;
+
+    // For lru, most recently used first. For clock, the hand points to
+    // the next entry to examine and new entries are inserted just
+    // before it.
+    //
+    entry_list list_;
+    entry_list::iterator hand_;
+
+    std::size_t size_;
+    std::size_t bytes_;
+
+    std::size_t hits_;
+    std::size_t misses_;
+    std::size_t evictions_;
+  };
+
+  namespace details
+  {
+    // Return true if the object pointer is not the only reference to the
+    // object. Raw pointers do not carry this information.
+    //
+    template <typename P, pointer_kind = pointer_traits<P>::kind>
+    struct pointer_shared
+    {
+      static bool
+      test (const P&) {return false;}
+    };
+
+    template <typename P>
+    struct pointer_shared<P, pk_shared>
+    {
+      static bool
+      test (const P& p) {return p.use_count () > 1;}
+    };
+  }
+}
+
+#include <odb/bounded-session.ixx>
+#include <odb/bounded-session.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_BOUNDED_SESSION_HXX
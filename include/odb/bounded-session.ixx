@@ -0,0 +1,238 @@
+// file      : odb/bounded-session.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/exceptions.hxx>
+
+namespace odb
+{
+  template <typename S>
+  ODB_TLS_POINTER (S) bounded_session::current_<S>::value;
+
+  template <typename S>
+  details::atomic_count bounded_session::type_index_<S>::next = 0;
+
+  inline bounded_session::
+  bounded_session (std::size_t max_objects,
+                   std::size_t max_bytes,
+                   eviction_policy policy,
+                   bool make_current)
+      : max_objects_ (max_objects),
+        max_bytes_ (max_bytes),
+        policy_ (policy),
+        hand_ (list_.end ()),
+        size_ (0),
+        bytes_ (0),
+        hits_ (0),
+        misses_ (0),
+        evictions_ (0)
+  {
+    if (make_current)
+    {
+      if (has_current ())
+        throw already_in_session ();
+
+      current_pointer (this);
+    }
+  }
+
+  inline bounded_session::
+  ~bounded_session ()
+  {
+    // If we are the current thread's session, reset it.
+    //
+    if (current_pointer () == this)
+      reset_current ();
+
+    for (entry_list::iterator i (list_.begin ()); i != list_.end (); ++i)
+      delete *i;
+  }
+
+  inline bounded_session::statistics_type bounded_session::
+  statistics () const
+  {
+    statistics_type r;
+    r.hits = hits_;
+    r.misses = misses_;
+    r.evictions = evictions_;
+    r.size = size_;
+    r.bytes = bytes_;
+    return r;
+  }
+
+  inline bounded_session* bounded_session::
+  current_pointer ()
+  {
+    return details::tls_get (current_<bounded_session>::value);
+  }
+
+  inline void bounded_session::
+  current_pointer (bounded_session* s)
+  {
+    details::tls_set (current_<bounded_session>::value, s);
+  }
+
+  inline bounded_session& bounded_session::
+  current ()
+  {
+    bounded_session* s (current_pointer ());
+
+    if (s == 0)
+      throw not_in_session ();
+
+    return *s;
+  }
+
+  template <typename T>
+  inline std::size_t bounded_session::
+  type_index ()
+  {
+    static const std::size_t i (
+      details::atomic_add (type_index_<void>::next, 1) - 1);
+    return i;
+  }
+
+  inline bool bounded_session::
+  over_budget () const
+  {
+    return (max_objects_ != 0 && size_ > max_objects_) ||
+      (max_bytes_ != 0 && bytes_ > max_bytes_);
+  }
+
+  inline void bounded_session::
+  link (entry_base& e)
+  {
+    // With CLOCK, a new entry is examined last.
+    //
+    e.pos = list_.insert (policy_ == lru ? list_.begin () : hand_, &e);
+    size_++;
+    bytes_ += e.size;
+  }
+
+  inline bounded_session::entry_list::iterator bounded_session::
+  erase (entry_list::iterator i)
+  {
+    entry_base* e (*i);
+
+    e->unlink ();
+    size_--;
+    bytes_ -= e->size;
+
+    bool hand (hand_ == i);
+    entry_list::iterator r (list_.erase (i));
+
+    if (hand)
+      hand_ = r;
+
+    delete e;
+    return r;
+  }
+
+  inline void bounded_session::
+  evict ()
+  {
+    if (!over_budget ())
+      return;
+
+    if (policy_ == lru)
+    {
+      // Go from the least recently used entry skipping the ones that
+      // cannot be evicted.
+      //
+      for (entry_list::iterator i (list_.end ());
+           i != list_.begin () && over_budget ();)
+      {
+        --i;
+
+        if (evictable (**i))
+        {
+          i = erase (i);
+          evictions_++;
+        }
+      }
+    }
+    else
+    {
+      // Every entry is examined at most twice: the first time to clear
+      // its reference flag and the second time to evict it.
+      //
+      for (std::size_t n (2 * size_); n != 0 && over_budget (); --n)
+      {
+        if (hand_ == list_.end ())
+          hand_ = list_.begin ();
+
+        entry_base& e (**hand_);
+
+        if (e.used)
+        {
+          e.used = false;
+          ++hand_;
+        }
+        else if (evictable (e))
+        {
+          hand_ = erase (hand_);
+          evictions_++;
+        }
+        else
+          ++hand_;
+      }
+    }
+  }
+
+  template <typename T>
+  inline typename bounded_session::cache_position<T> bounded_session::
+  _cache_insert (database_type& db,
+                 const typename object_traits<T>::id_type& id,
+                 const typename object_traits<T>::pointer_type& obj)
+  {
+    if (bounded_session* s = current_pointer ())
+      return s->cache_insert<T> (db, id, obj);
+    else
+      return cache_position<T> ();
+  }
+
+  template <typename T>
+  inline typename object_traits<T>::pointer_type bounded_session::
+  _cache_find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    if (bounded_session* s = current_pointer ())
+      return s->cache_find<T> (db, id);
+    else
+      return pointer_type ();
+  }
+
+  template <typename T>
+  inline void bounded_session::
+  _cache_erase (const cache_position<T>& p)
+  {
+    if (p.map_ != 0)
+      p.map_->session.cache_erase (p);
+  }
+
+  template <typename T>
+  inline void bounded_session::
+  _cache_release (const cache_position<T>& p)
+  {
+    if (p.map_ != 0)
+      p.map_->session.cache_release (p);
+  }
+
+  template <typename T>
+  inline void bounded_session::
+  _cache_update (database_type& db, const T& obj)
+  {
+    if (bounded_session* s = current_pointer ())
+      s->cache_update (db, obj);
+  }
+
+  template <typename T>
+  inline void bounded_session::
+  _cache_erase (database_type& db,
+                const typename object_traits<T>::id_type& id)
+  {
+    if (bounded_session* s = current_pointer ())
+      s->cache_erase<T> (db, id);
+  }
+}
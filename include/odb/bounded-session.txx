@@ -0,0 +1,210 @@
+// file      : odb/bounded-session.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/details/unique-ptr.hxx>
+
+namespace odb
+{
+  //
+  // entry
+  //
+
+  template <typename T>
+  bool bounded_session::entry<T>::
+  referenced () const
+  {
+    return details::pointer_shared<pointer_type>::test (obj);
+  }
+
+  template <typename T>
+  void bounded_session::entry<T>::
+  measure ()
+  {
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    bounded_session& s (map.session);
+    s.bytes_ -= size;
+    size = object_size<T>::size (pointer_traits::get_ref (obj));
+    s.bytes_ += size;
+  }
+
+  //
+  // bounded_session
+  //
+
+  template <typename T>
+  bounded_session::object_map<T>& bounded_session::
+  map (database_type& db)
+  {
+    database_map::iterator di (db_map_.begin ());
+
+    for (; di != db_map_.end () && di->db != &db; ++di) ;
+
+    if (di == db_map_.end ())
+    {
+      database_entry e;
+      e.db = &db;
+      di = db_map_.insert (db_map_.end (), e);
+    }
+
+    type_map& tm (di->types);
+    std::size_t i (type_index<T> ());
+
+    if (i >= tm.size ())
+      tm.resize (i + 1);
+
+    details::shared_ptr<object_map_base>& pom (tm[i]);
+
+    if (!pom)
+      pom.reset (new (details::shared) object_map<T> (*this));
+
+    return static_cast<object_map<T>&> (*pom);
+  }
+
+  template <typename T>
+  bounded_session::object_map<T>* bounded_session::
+  find_map (database_type& db) const
+  {
+    database_map::const_iterator di (db_map_.begin ());
+
+    for (; di != db_map_.end () && di->db != &db; ++di) ;
+
+    if (di == db_map_.end ())
+      return 0;
+
+    const type_map& tm (di->types);
+    std::size_t i (type_index<T> ());
+
+    if (i >= tm.size () || !tm[i])
+      return 0;
+
+    return static_cast<object_map<T>*> (tm[i].get ());
+  }
+
+  template <typename T>
+  typename bounded_session::cache_position<T> bounded_session::
+  cache_insert (database_type& db,
+                const typename object_traits<T>::id_type& id,
+                const typename object_traits<T>::pointer_type& obj)
+  {
+    object_map<T>& om (map<T> (db));
+    typename object_map<T>::iterator i (om.find (id));
+
+    if (i != om.end ())
+    {
+      // In what situation may we possibly attempt to reinsert the object?
+      // See session::cache_insert() for details.
+      //
+      entry<T>& e (*i->second);
+      e.obj = obj;
+      e.pinned = true;
+      e.measure ();
+    }
+    else
+    {
+      details::unique_ptr<entry<T> > e (new entry<T> (om, id, obj));
+      om.insert (typename object_map<T>::value_type (id, e.get ()));
+
+      try
+      {
+        link (*e);
+      }
+      catch (...)
+      {
+        om.erase (id);
+        throw;
+      }
+
+      e.release ()->measure ();
+    }
+
+    evict ();
+    return cache_position<T> (om, id);
+  }
+
+  template <typename T>
+  typename object_traits<T>::pointer_type bounded_session::
+  cache_find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    if (object_map<T>* om = find_map<T> (db))
+    {
+      typename object_map<T>::iterator i (om->find (id));
+
+      if (i != om->end ())
+      {
+        entry<T>& e (*i->second);
+
+        if (policy_ == lru)
+          list_.splice (list_.begin (), list_, e.pos);
+        else
+          e.used = true;
+
+        hits_++;
+        return e.obj;
+      }
+    }
+
+    misses_++;
+    return pointer_type ();
+  }
+
+  template <typename T>
+  void bounded_session::
+  cache_erase (const cache_position<T>& p)
+  {
+    object_map<T>& om (*p.map_);
+    typename object_map<T>::iterator i (om.find (p.id_));
+
+    if (i != om.end ())
+      erase (i->second->pos);
+  }
+
+  template <typename T>
+  void bounded_session::
+  cache_erase (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    if (object_map<T>* om = find_map<T> (db))
+    {
+      typename object_map<T>::iterator i (om->find (id));
+
+      if (i != om->end ())
+        erase (i->second->pos);
+    }
+  }
+
+  template <typename T>
+  void bounded_session::
+  cache_release (const cache_position<T>& p)
+  {
+    object_map<T>& om (*p.map_);
+    typename object_map<T>::iterator i (om.find (p.id_));
+
+    if (i != om.end ())
+    {
+      entry<T>& e (*i->second);
+      e.pinned = false;
+      e.measure ();
+      evict ();
+    }
+  }
+
+  template <typename T>
+  void bounded_session::
+  cache_update (database_type& db, const T& obj)
+  {
+    if (object_map<T>* om = find_map<T> (db))
+    {
+      typename object_map<T>::iterator i (
+        om->find (object_traits<T>::id (obj)));
+
+      if (i != om->end ())
+      {
+        i->second->measure ();
+        evict ();
+      }
+    }
+  }
+}
@@ -7,6 +7,9 @@
 
 #include <odb/pre.hxx>
 
+#include <vector>
+#include <cstddef> // std::size_t
+
 #include <odb/forward.hxx>
 #include <odb/details/config.hxx> // ODB_CXX11
 
@@ -27,6 +30,32 @@ namespace odb
   // Container API provided by the generated code.
   //
 
+  // Insert n elements with consecutive indexes starting with the
+  // specified one. If supported by the database (insert_n is not NULL),
+  // the elements are inserted in batches rather than one statement
+  // execution at a time.
+  //
+  template <typename I, typename V>
+  inline void
+  container_insert_n (void (*insert) (I, const V&, void*),
+                      void (*insert_n) (I,
+                                        const V* const*,
+                                        std::size_t,
+                                        void*),
+                      I index,
+                      const V* const* values,
+                      std::size_t n,
+                      void* data)
+  {
+    if (insert_n != 0)
+      insert_n (index, values, n, data);
+    else
+    {
+      for (std::size_t i (0); i != n; ++i)
+        insert (index + static_cast<I> (i), *values[i], data);
+    }
+  }
+
   // Ordered containers.
   //
   template <typename I, typename V>
@@ -51,6 +80,14 @@ namespace odb
       insert_ (index, value, data_);
     }
 
+    // See container_insert_n() above.
+    //
+    void
+    insert (I index, const V* const* values, std::size_t n) const
+    {
+      container_insert_n (insert_, insert_n_, index, values, n, data_);
+    }
+
     bool
     select (I& next_index, V& next_value) const
     {
@@ -66,13 +103,14 @@ namespace odb
     // Implementation details.
     //
   public:
-    ordered_functions (void* data): data_ (data) {}
+    ordered_functions (void* data): data_ (data), insert_n_ (0) {}
 
   public:
     void* data_;
     bool ordered_;
 
     void (*insert_) (I, const V&, void*);
+    void (*insert_n_) (I, const V* const*, std::size_t, void*);
     bool (*select_) (I&, V&, void*);
     void (*delete__) (void*);
   };
@@ -89,6 +127,14 @@ namespace odb
       insert_ (index, value, data_);
     }
 
+    // See container_insert_n() above.
+    //
+    void
+    insert (I index, const V* const* values, std::size_t n) const
+    {
+      container_insert_n (insert_, insert_n_, index, values, n, data_);
+    }
+
     bool
     select (I& next_index, V& next_value) const
     {
@@ -113,17 +159,103 @@ namespace odb
     // Implementation details.
     //
   public:
-    smart_ordered_functions (void* data) : data_ (data) {}
+    smart_ordered_functions (void* data) : data_ (data), insert_n_ (0) {}
 
   public:
     void* data_;
 
     void (*insert_) (I, const V&, void*);
+    void (*insert_n_) (I, const V* const*, std::size_t, void*);
     bool (*select_) (I&, V&, void*);
     void (*update_) (I, const V&, void*);
     void (*delete__) (I, void*);
   };
 
+  // Insert elements [b, e) of a random-access container using their
+  // positions as indexes. F is one of the ordered functions above. The
+  // whole range is passed in one call so that the database can choose
+  // the batch size. Containers that do not return references to their
+  // elements, such as std::vector<bool>, have the elements inserted one
+  // by one.
+  //
+  template <typename R, typename V>
+  struct container_element_reference
+  {
+    static const bool result = false;
+  };
+
+  template <typename V>
+  struct container_element_reference<const V&, V>
+  {
+    static const bool result = true;
+  };
+
+  template <typename F,
+            typename C,
+            bool = container_element_reference<
+              typename C::const_reference,
+              typename F::value_type>::result>
+  struct insert_range_impl
+  {
+    typedef typename F::index_type index_type;
+
+    static void
+    insert (const F& f, const C& c, index_type b, std::size_t n)
+    {
+      for (std::size_t i (0); i != n; ++i)
+      {
+        index_type j (b + static_cast<index_type> (i));
+        f.insert (j, c[j]);
+      }
+    }
+  };
+
+  template <typename F, typename C>
+  struct insert_range_impl<F, C, true>
+  {
+    typedef typename F::index_type index_type;
+    typedef typename F::value_type value_type;
+
+    static void
+    insert (const F& f, const C& c, index_type b, std::size_t n)
+    {
+      // Avoid the allocation for small ranges.
+      //
+      const std::size_t small (64);
+
+      if (n <= small)
+      {
+        const value_type* vs[small];
+
+        for (std::size_t i (0); i != n; ++i)
+          vs[i] = &c[b + static_cast<index_type> (i)];
+
+        f.insert (b, vs, n);
+      }
+      else
+      {
+        std::vector<const value_type*> vs (n);
+
+        for (std::size_t i (0); i != n; ++i)
+          vs[i] = &c[b + static_cast<index_type> (i)];
+
+        f.insert (b, &vs[0], n);
+      }
+    }
+  };
+
+  template <typename F, typename C>
+  inline void
+  insert_range (const F& f,
+                const C& c,
+                typename F::index_type b,
+                typename F::index_type e)
+  {
+    if (b != e)
+      insert_range_impl<F, C>::insert (
+        f, c, b, static_cast<std::size_t> (e - b));
+  }
+
   // Set/multiset containers.
   //
   template <typename V>
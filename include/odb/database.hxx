@@ -73,6 +73,16 @@ namespace odb
     typename object_traits<T>::id_type
     persist (const typename object_traits<T>::pointer_type& obj_ptr);
 
+    // Make a range of objects persistent. The iterator value type can be
+    // an object or an object pointer. Elements that are already persistent
+    // do not abort the operation; instead, they are collected and reported
+    // at the end by throwing multiple_exceptions. If continue_failed is
+    // false, then stop at the first such element.
+    //
+    template <typename I>
+    void
+    persist (I begin, I end, bool continue_failed = true);
+
     // Load an object. Throw object_not_persistent if not found.
     //
     template <typename T>
@@ -153,6 +163,17 @@ namespace odb
     void
     update (const typename object_traits<T>::pointer_type& obj_ptr);
 
+    // Update a range of objects. The iterator value type can be an object
+    // or an object pointer. Elements that are not persistent or whose
+    // state has changed in the database (optimistic concurrency) do not
+    // abort the operation; instead, they are collected and reported at
+    // the end by throwing multiple_exceptions. If continue_failed is
+    // false, then stop at the first such element.
+    //
+    template <typename I>
+    void
+    update (I begin, I end, bool continue_failed = true);
+
     // Make the object transient. Throw object_not_persistent if not
     // found.
     //
@@ -188,6 +209,13 @@ namespace odb
     void
     erase (const typename object_traits<T>::pointer_type& obj_ptr);
 
+    // Erase a range of objects given their ids. Elements that are not
+    // persistent are handled as in the range update() above.
+    //
+    template <typename T, typename I>
+    void
+    erase (I id_begin, I id_end, bool continue_failed = true);
+
     // Erase multiple objects matching a query predicate.
     //
     template <typename T>
@@ -343,6 +371,21 @@ namespace odb
     typename object_traits<T>::id_type
     persist_ (const typename object_traits<T>::pointer_type&);
 
+    // Range versions. The D template argument is the database type
+    // whose single-object functions should be called for each element.
+    //
+    template <typename D, typename I>
+    static void
+    persist_range_ (D&, I begin, I end, bool continue_failed);
+
+    template <typename D, typename I>
+    static void
+    update_range_ (D&, I begin, I end, bool continue_failed);
+
+    template <typename T, typename D, typename I>
+    static void
+    erase_range_ (D&, I id_begin, I id_end, bool continue_failed);
+
     template <typename T, database_id DB>
     typename object_traits<T>::pointer_type
     load_ (const typename object_traits<T>::id_type&);
@@ -146,6 +146,13 @@ namespace odb
     return persist_<T, id_common> (pobj);
   }
 
+  template <typename I>
+  inline void database::
+  persist (I b, I e, bool cont)
+  {
+    persist_range_ (*this, b, e, cont);
+  }
+
   template <typename T>
   inline typename object_traits<T>::pointer_type database::
   load (const typename object_traits<T>::id_type& id)
@@ -300,6 +307,13 @@ namespace odb
     update_<T, id_common> (pobj);
   }
 
+  template <typename I>
+  inline void database::
+  update (I b, I e, bool cont)
+  {
+    update_range_ (*this, b, e, cont);
+  }
+
   template <typename T>
   inline void database::
   erase (const typename object_traits<T>::id_type& id)
@@ -382,6 +396,13 @@ namespace odb
     erase_<T, id_common> (pobj);
   }
 
+  template <typename T, typename I>
+  inline void database::
+  erase (I b, I e, bool cont)
+  {
+    erase_range_<T> (*this, b, e, cont);
+  }
+
   template <typename T>
   inline unsigned long long database::
   erase_query ()
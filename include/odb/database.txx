@@ -70,6 +70,120 @@ namespace odb
     return object_traits::id (obj);
   }
 
+  template <typename D, typename I>
+  void database::
+  persist_range_ (D& db, I b, I e, bool cont)
+  {
+    // Each element goes through the single-object persist() which uses
+    // the insert statement cached in the connection's statement cache.
+    // As a result, the statement is prepared once for the whole range.
+    //
+    multiple_exceptions mex;
+    std::size_t n (0);
+
+    for (; b != e; ++b)
+    {
+      try
+      {
+        n++;
+        db.persist (*b);
+      }
+      catch (const object_already_persistent& ex)
+      {
+        mex.insert (n - 1, ex);
+
+        if (!cont)
+          break;
+      }
+    }
+
+    if (!mex.empty ())
+    {
+      mex.attempted (n);
+      mex.prepare ();
+      throw mex;
+    }
+  }
+
+  template <typename D, typename I>
+  void database::
+  update_range_ (D& db, I b, I e, bool cont)
+  {
+    // As with persist, the update statement is prepared once for the
+    // whole range. The single-object update() also keeps the session
+    // consistent.
+    //
+    multiple_exceptions mex;
+    std::size_t n (0);
+
+    for (; b != e; ++b)
+    {
+      try
+      {
+        n++;
+        db.update (*b);
+      }
+      catch (const object_not_persistent& ex)
+      {
+        mex.insert (n - 1, ex);
+
+        if (!cont)
+          break;
+      }
+      catch (const object_changed& ex)
+      {
+        mex.insert (n - 1, ex);
+
+        if (!cont)
+          break;
+      }
+    }
+
+    if (!mex.empty ())
+    {
+      mex.attempted (n);
+      mex.prepare ();
+      throw mex;
+    }
+  }
+
+  template <typename T, typename D, typename I>
+  void database::
+  erase_range_ (D& db, I b, I e, bool cont)
+  {
+    // The single-object erase() removes the object from the session,
+    // if any.
+    //
+    typedef typename object_traits<T>::id_type id_type;
+
+    multiple_exceptions mex;
+    std::size_t n (0);
+
+    for (; b != e; ++b)
+    {
+      try
+      {
+        n++;
+        const id_type& id (*b);
+        db.template erase<T> (id);
+      }
+      catch (const object_not_persistent& ex)
+      {
+        mex.insert (n - 1, ex);
+
+        if (!cont)
+          break;
+      }
+    }
+
+    if (!mex.empty ())
+    {
+      mex.attempted (n);
+      mex.prepare ();
+      throw mex;
+    }
+  }
+
   template <typename T, database_id DB>
   typename object_traits<T>::pointer_type database::
   load_ (const typename object_traits<T>::id_type& id)
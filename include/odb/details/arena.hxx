@@ -0,0 +1,143 @@
+// file      : odb/details/arena.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_DETAILS_ARENA_HXX
+#define ODB_DETAILS_ARENA_HXX
+
+#include <odb/pre.hxx>
+
+#include <new>     // operator new/delete
+#include <vector>
+#include <cstddef> // std::size_t
+
+namespace odb
+{
+  namespace details
+  {
+    // Bump allocator with N bytes of inline storage. Once the inline
+    // storage is exhausted, additional blocks are allocated on the heap.
+    // Memory is only released when the arena is destroyed.
+    //
+    template <std::size_t N>
+    class arena
+    {
+    public:
+      arena (): pos_ (0), blocks_ (0) {}
+      ~arena ();
+
+      // Return memory suitably aligned for any fundamental type.
+      //
+      void*
+      allocate (std::size_t);
+
+    private:
+      arena (const arena&);
+      arena& operator= (const arena&);
+
+    private:
+      union max_align
+      {
+        long double ld;
+        long long ll;
+        double d;
+        void* p;
+      };
+
+      static const std::size_t alignment = sizeof (max_align);
+
+      struct block
+      {
+        block* next;
+        std::size_t size;
+        std::size_t pos;
+      };
+
+      static const std::size_t block_header =
+        (sizeof (block) + alignment - 1) / alignment * alignment;
+
+      union
+      {
+        char data_[N];
+        max_align align_;
+      };
+
+      std::size_t pos_;
+      block* blocks_;
+    };
+
+    // Vector that keeps up to N elements inline and only moves them to
+    // the heap once this number is exceeded. The elements are always
+    // contiguous. X should be copy-assignable and default-constructible.
+    //
+    template <typename X, std::size_t N>
+    class small_vector
+    {
+    public:
+      small_vector (): size_ (0) {}
+
+      std::size_t
+      size () const
+      {
+        return size_;
+      }
+
+      bool
+      empty () const
+      {
+        return size_ == 0;
+      }
+
+      X*
+      data ()
+      {
+        return size_ <= N ? inline_ : &heap_[0];
+      }
+
+      const X*
+      data () const
+      {
+        return size_ <= N ? inline_ : &heap_[0];
+      }
+
+      X&
+      operator[] (std::size_t i)
+      {
+        return data ()[i];
+      }
+
+      const X&
+      operator[] (std::size_t i) const
+      {
+        return data ()[i];
+      }
+
+      X&
+      back ()
+      {
+        return data ()[size_ - 1];
+      }
+
+      void
+      push_back (const X&);
+
+      void
+      clear ()
+      {
+        heap_.clear ();
+        size_ = 0;
+      }
+
+    private:
+      X inline_[N];
+      std::vector<X> heap_;
+      std::size_t size_;
+    };
+  }
+}
+
+#include <odb/details/arena.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_DETAILS_ARENA_HXX
@@ -0,0 +1,79 @@
+// file      : odb/details/arena.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  namespace details
+  {
+    //
+    // arena
+    //
+
+    template <std::size_t N>
+    arena<N>::
+    ~arena ()
+    {
+      for (block* b (blocks_); b != 0;)
+      {
+        block* n (b->next);
+        operator delete (b);
+        b = n;
+      }
+    }
+
+    template <std::size_t N>
+    void* arena<N>::
+    allocate (std::size_t n)
+    {
+      n = (n + alignment - 1) / alignment * alignment;
+
+      if (N - pos_ >= n)
+      {
+        void* r (data_ + pos_);
+        pos_ += n;
+        return r;
+      }
+
+      if (blocks_ == 0 || blocks_->size - blocks_->pos < n)
+      {
+        // Each new block is at least as big as the inline storage.
+        //
+        std::size_t s (n > N ? n : N);
+
+        block* b (
+          static_cast<block*> (operator new (block_header + s)));
+        b->next = blocks_;
+        b->size = s;
+        b->pos = 0;
+        blocks_ = b;
+      }
+
+      char* d (reinterpret_cast<char*> (blocks_) + block_header);
+      void* r (d + blocks_->pos);
+      blocks_->pos += n;
+      return r;
+    }
+
+    //
+    // small_vector
+    //
+
+    template <typename X, std::size_t N>
+    void small_vector<X, N>::
+    push_back (const X& x)
+    {
+      if (size_ < N)
+        inline_[size_] = x;
+      else
+      {
+        if (size_ == N)
+          heap_.assign (inline_, inline_ + N);
+
+        heap_.push_back (x);
+      }
+
+      ++size_;
+    }
+  }
+}
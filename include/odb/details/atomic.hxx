@@ -0,0 +1,97 @@
+// file      : odb/details/atomic.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_DETAILS_ATOMIC_HXX
+#define ODB_DETAILS_ATOMIC_HXX
+
+#include <odb/pre.hxx>
+
+#include <cstddef> // std::size_t
+
+#include <odb/details/config.hxx>
+
+#if !defined(ODB_THREADS_NONE) && defined(_MSC_VER)
+#  include <windows.h>
+#endif
+
+namespace odb
+{
+  namespace details
+  {
+    // A minimal set of atomic operations on std::size_t values. All of
+    // them act as full memory barriers.
+    //
+    typedef volatile std::size_t atomic_count;
+
+    // Set x to n if it is equal to o. Return true if the value was set.
+    //
+    inline bool
+    atomic_cas (atomic_count& x, std::size_t o, std::size_t n)
+    {
+#if defined(ODB_THREADS_NONE)
+      if (x != o)
+        return false;
+
+      x = n;
+      return true;
+#elif defined(_MSC_VER)
+#  ifdef _WIN64
+      return static_cast<std::size_t> (
+        InterlockedCompareExchange64 (
+          reinterpret_cast<volatile LONGLONG*> (&x),
+          static_cast<LONGLONG> (n),
+          static_cast<LONGLONG> (o))) == o;
+#  else
+      return static_cast<std::size_t> (
+        InterlockedCompareExchange (
+          reinterpret_cast<volatile LONG*> (&x),
+          static_cast<LONG> (n),
+          static_cast<LONG> (o))) == o;
+#  endif
+#else
+      return __sync_bool_compare_and_swap (&x, o, n);
+#endif
+    }
+
+    // Add v to x and return the new value.
+    //
+    inline std::size_t
+    atomic_add (atomic_count& x, std::size_t v)
+    {
+#if defined(ODB_THREADS_NONE)
+      return x += v;
+#elif defined(_MSC_VER)
+#  ifdef _WIN64
+      return static_cast<std::size_t> (
+        InterlockedExchangeAdd64 (
+          reinterpret_cast<volatile LONGLONG*> (&x),
+          static_cast<LONGLONG> (v))) + v;
+#  else
+      return static_cast<std::size_t> (
+        InterlockedExchangeAdd (
+          reinterpret_cast<volatile LONG*> (&x),
+          static_cast<LONG> (v))) + v;
+#  endif
+#else
+      return __sync_add_and_fetch (&x, v);
+#endif
+    }
+
+    inline std::size_t
+    atomic_sub (atomic_count& x, std::size_t v)
+    {
+      return atomic_add (x, static_cast<std::size_t> (0) - v);
+    }
+
+    inline std::size_t
+    atomic_load (atomic_count& x)
+    {
+      return atomic_add (x, 0);
+    }
+  }
+}
+
+#include <odb/post.hxx>
+
+#endif // ODB_DETAILS_ATOMIC_HXX
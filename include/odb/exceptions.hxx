@@ -8,11 +8,14 @@
 #include <odb/pre.hxx>
 
 #include <string>
+#include <vector>
+#include <cstddef> // std::size_t
 
 #include <odb/forward.hxx>    // odb::core
 #include <odb/exception.hxx>
 
 #include <odb/details/export.hxx>
+#include <odb/details/shared-ptr.hxx>
 
 namespace odb
 {
@@ -189,6 +192,131 @@ namespace odb
     std::string what_;
   };
 
+  // Bulk operation exceptions.
+  //
+  // Thrown by the range versions of the database operations (for example,
+  // persist(begin, end)) if one or more elements have failed. For each
+  // failed element we store its position in the range and a copy of the
+  // exception that the single-object version would have thrown.
+  //
+  struct multiple_exceptions: exception
+  {
+    struct value_type
+    {
+      value_type (std::size_t p,
+                  const details::shared_ptr<odb::exception>& e)
+          : position_ (p), exception_ (e)
+      {
+      }
+
+      std::size_t
+      position () const
+      {
+        return position_;
+      }
+
+      const odb::exception&
+      exception () const
+      {
+        return *exception_;
+      }
+
+    private:
+      std::size_t position_;
+      details::shared_ptr<odb::exception> exception_;
+    };
+
+    typedef std::vector<value_type> set_type;
+
+    typedef set_type::const_iterator iterator;
+    typedef set_type::const_iterator const_iterator;
+
+    multiple_exceptions (): attempted_ (0), delta_ (0) {}
+    ~multiple_exceptions () throw () {}
+
+    iterator
+    begin () const
+    {
+      return set_.begin ();
+    }
+
+    iterator
+    end () const
+    {
+      return set_.end ();
+    }
+
+    std::size_t
+    size () const
+    {
+      return set_.size ();
+    }
+
+    bool
+    empty () const
+    {
+      return set_.empty ();
+    }
+
+    // Number of elements for which the operation was attempted. This
+    // can be less than the range size if the operation was stopped at
+    // the first failure.
+    //
+    std::size_t
+    attempted () const
+    {
+      return attempted_;
+    }
+
+    std::size_t
+    failed () const
+    {
+      return set_.size ();
+    }
+
+    virtual const char*
+    what () const throw ();
+
+    // Implementation details.
+    //
+  public:
+    template <typename E>
+    void
+    insert (std::size_t position, const E& e)
+    {
+      set_.push_back (
+        value_type (position + delta_,
+                    details::shared_ptr<odb::exception> (
+                      new (details::shared) E (e))));
+    }
+
+    // Offset added to the positions passed to insert(). Bulk operations
+    // set it to the position of the current batch in the range.
+    //
+    void
+    delta (std::size_t d)
+    {
+      delta_ = d;
+    }
+
+    void
+    attempted (std::size_t n)
+    {
+      attempted_ = n;
+    }
+
+    // Prepare the what() string. Should be called before throwing.
+    //
+    void
+    prepare ();
+
+  private:
+    set_type set_;
+    std::size_t attempted_;
+    std::size_t delta_;
+    std::string what_;
+  };
+
   namespace common
   {
     using odb::null_pointer;
@@ -215,9 +343,13 @@ namespace odb
     using odb::no_type_info;
 
     using odb::unknown_schema;
+
+    using odb::multiple_exceptions;
   }
 }
 
+#include <odb/exceptions.ixx>
+
 #include <odb/post.hxx>
 
 #endif // ODB_EXCEPTIONS_HXX
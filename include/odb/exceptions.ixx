@@ -0,0 +1,35 @@
+// file      : odb/exceptions.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <sstream>
+
+namespace odb
+{
+  // multiple_exceptions
+  //
+  inline const char* multiple_exceptions::
+  what () const throw ()
+  {
+    return what_.c_str ();
+  }
+
+  inline void multiple_exceptions::
+  prepare ()
+  {
+    std::ostringstream os;
+    os << "multiple exceptions, "
+       << attempted_ << " element" << (attempted_ != 1 ? "s" : "")
+       << " attempted, "
+       << set_.size () << " failed";
+
+    if (!set_.empty ())
+    {
+      const value_type& v (set_.front ());
+      os << ", first at position " << v.position () << ": "
+         << v.exception ().what ();
+    }
+
+    what_ = os.str ();
+  }
+}
@@ -0,0 +1,372 @@
+// file      : odb/hash-session.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_HASH_SESSION_HXX
+#define ODB_HASH_SESSION_HXX
+
+#include <odb/pre.hxx>
+
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/traits.hxx>
+#include <odb/forward.hxx>
+
+#include <odb/details/tls.hxx>
+#include <odb/details/config.hxx> // ODB_CXX11
+#include <odb/details/atomic.hxx>
+#include <odb/details/shared-ptr.hxx>
+
+#ifdef ODB_CXX11
+#  include <functional> // std::hash
+#endif
+
+namespace odb
+{
+  // Hash function for object ids as used by hash_session. It is
+  // specialized for the built-in integer types and std::string. For
+  // other id types either specialize this template or, in C++11,
+  // provide a std::hash specialization.
+  //
+  template <typename T>
+  struct id_hash
+  {
+#ifdef ODB_CXX11
+    std::size_t
+    operator() (const T& x) const
+    {
+      return std::hash<T> () (x);
+    }
+#endif
+  };
+
+  // Session with the object cache built on open-addressing hash tables
+  // rather than on std::map. Finding the object map for a type is a
+  // vector lookup using a per-type slot index and finding the object in
+  // this map is a hash table probe. This session type is meant for
+  // sessions holding large numbers of objects and is selected with the
+  // --session-type ODB compiler option (or the session pragma).
+  //
+  // The interface mirrors odb::session except that the low-level map()
+  // access is not provided.
+  //
+  class hash_session
+  {
+  public:
+    typedef odb::database database_type;
+
+    // If the make_current argument is true, then set the current thread's
+    // session to this session. If another session is already in effect,
+    // throw the already_in_session exception.
+    //
+    hash_session (bool make_current = true);
+
+    // Reset the current thread's session if it is this session.
+    //
+    ~hash_session ();
+
+    // Current session.
+    //
+  public:
+    static bool
+    has_current () {return current_pointer () != 0;}
+
+    // Get current thread's session. Throw if no session is in effect.
+    //
+    static hash_session&
+    current ();
+
+    static void
+    current (hash_session& s) {current_pointer (&s);}
+
+    static void
+    reset_current () {current_pointer (0);}
+
+    static hash_session*
+    current_pointer ();
+
+    static void
+    current_pointer (hash_session*);
+
+    // Copying or assignment of sessions is not supported.
+    //
+  private:
+    hash_session (const hash_session&);
+    hash_session& operator= (const hash_session&);
+
+  public:
+    struct object_map_base: details::shared_base
+    {
+      virtual
+      ~object_map_base () {}
+    };
+
+    // Open-addressing (linear probing) hash table mapping object ids to
+    // object pointers.
+    //
+    template <typename T>
+    class object_map: public object_map_base
+    {
+    public:
+      typedef typename object_traits<T>::id_type id_type;
+      typedef typename object_traits<T>::pointer_type pointer_type;
+
+      object_map (): size_ (0) {}
+
+      std::size_t
+      size () const {return size_;}
+
+      bool
+      empty () const {return size_ == 0;}
+
+      // Return NULL if not found.
+      //
+      const pointer_type*
+      find (const id_type&) const;
+
+      // Insert or replace the existing entry.
+      //
+      void
+      insert (const id_type&, const pointer_type&);
+
+      // Return false if not found.
+      //
+      bool
+      erase (const id_type&);
+
+    private:
+      struct entry
+      {
+        entry (): used (false), hash (0) {}
+
+        bool used;
+        std::size_t hash;
+        id_type id;
+        pointer_type obj;
+      };
+
+      typedef std::vector<entry> table;
+
+      static std::size_t
+      hash (const id_type&);
+
+      // Return the index of the entry with this id or of the empty
+      // entry where it should be inserted. The table must not be empty.
+      //
+      std::size_t
+      probe (const id_type&, std::size_t hash) const;
+
+      void
+      grow ();
+
+    private:
+      table table_;
+      std::size_t size_;
+    };
+
+    // Object cache.
+    //
+  public:
+    template <typename T>
+    struct cache_position;
+
+    template <typename T>
+    cache_position<T>
+    cache_insert (database_type&,
+                  const typename object_traits<T>::id_type&,
+                  const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    typename object_traits<T>::pointer_type
+    cache_find (database_type&,
+                const typename object_traits<T>::id_type&) const;
+
+    template <typename T>
+    void
+    cache_erase (const cache_position<T>&);
+
+    template <typename T>
+    void
+    cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+    // Static cache API as expected by the rest of ODB.
+    //
+  public:
+    // Position in the cache of the inserted element. Since inserting
+    // other objects (for example, while loading this one) can cause the
+    // table to be rehashed, the position is the object id rather than
+    // the table index.
+    //
+    template <typename T>
+    struct cache_position
+    {
+      typedef object_map<T> map;
+      typedef typename object_traits<T>::id_type id_type;
+
+      cache_position (): map_ (0) {}
+      cache_position (map& m, const id_type& id): map_ (&m), id_ (id) {}
+
+      map* map_;
+      id_type id_;
+    };
+
+    template <typename T>
+    static cache_position<T>
+    _cache_insert (database_type&,
+                   const typename object_traits<T>::id_type&,
+                   const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    static typename object_traits<T>::pointer_type
+    _cache_find (database_type&, const typename object_traits<T>::id_type&);
+
+    template <typename T>
+    static void
+    _cache_erase (const cache_position<T>&);
+
+    // Notifications. These are called after per-object callbacks for
+    // post_{persist, load, update, erase} events.
+    //
+    template <typename T>
+    static void
+    _cache_persist (const cache_position<T>&) {}
+
+    template <typename T>
+    static void
+    _cache_load (const cache_position<T>&) {}
+
+    template <typename T>
+    static void
+    _cache_update (database_type&, const T&) {}
+
+    template <typename T>
+    static void
+    _cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+  protected:
+    typedef std::vector<details::shared_ptr<object_map_base> > type_map;
+
+    struct database_entry
+    {
+      database_type* db;
+      type_map types;
+    };
+
+    typedef std::vector<database_entry> database_map;
+
+    // Return this type's index in type_map. Indexes are allocated on
+    // first use and are the same for all the sessions.
+    //
+    template <typename T>
+    static std::size_t
+    type_index ();
+
+    template <typename T>
+    object_map<T>&
+    map (database_type&);
+
+    template <typename T>
+    object_map<T>*
+    find_map (database_type&) const;
+
+    // These are templates only to allow the definition in the header.
+    //
+    template <typename S>
+    struct current_
+    {
+      static ODB_TLS_POINTER (S) value;
+    };
+
+    template <typename S>
+    struct type_index_
+    {
+      static details::atomic_count next;
+    };
+
+  protected:
+    database_map db_map_;
+  };
+
+  namespace details
+  {
+    template <typename T>
+    struct integer_id_hash
+    {
+      std::size_t
+      operator() (T x) const
+      {
+        return static_cast<std::size_t> (x);
+      }
+    };
+  }
+
+  template <>
+  struct id_hash<short>: details::integer_id_hash<short> {};
+
+  template <>
+  struct id_hash<unsigned short>: details::integer_id_hash<unsigned short> {};
+
+  template <>
+  struct id_hash<int>: details::integer_id_hash<int> {};
+
+  template <>
+  struct id_hash<unsigned int>: details::integer_id_hash<unsigned int> {};
+
+  template <>
+  struct id_hash<long>: details::integer_id_hash<long> {};
+
+  template <>
+  struct id_hash<unsigned long>: details::integer_id_hash<unsigned long> {};
+
+  template <>
+  struct id_hash<unsigned long long>
+  {
+    std::size_t
+    operator() (unsigned long long x) const
+    {
+      // Fold the high half in case std::size_t is 32 bits.
+      //
+      return static_cast<std::size_t> (x ^ (x >> 32));
+    }
+  };
+
+  template <>
+  struct id_hash<long long>
+  {
+    std::size_t
+    operator() (long long x) const
+    {
+      return id_hash<unsigned long long> () (
+        static_cast<unsigned long long> (x));
+    }
+  };
+
+  template <>
+  struct id_hash<std::string>
+  {
+    std::size_t
+    operator() (const std::string& x) const
+    {
+      // FNV-1a.
+      //
+      std::size_t h (2166136261U);
+
+      for (std::string::const_iterator i (x.begin ()); i != x.end (); ++i)
+      {
+        h ^= static_cast<unsigned char> (*i);
+        h *= 16777619U;
+      }
+
+      return h;
+    }
+  };
+}
+
+#include <odb/hash-session.ixx>
+#include <odb/hash-session.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_HASH_SESSION_HXX
@@ -0,0 +1,116 @@
+// file      : odb/hash-session.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/exceptions.hxx>
+
+namespace odb
+{
+  template <typename S>
+  ODB_TLS_POINTER (S) hash_session::current_<S>::value;
+
+  template <typename S>
+  details::atomic_count hash_session::type_index_<S>::next = 0;
+
+  inline hash_session::
+  hash_session (bool make_current)
+  {
+    if (make_current)
+    {
+      if (has_current ())
+        throw already_in_session ();
+
+      current_pointer (this);
+    }
+  }
+
+  inline hash_session::
+  ~hash_session ()
+  {
+    // If we are the current thread's session, reset it.
+    //
+    if (current_pointer () == this)
+      reset_current ();
+  }
+
+  inline hash_session* hash_session::
+  current_pointer ()
+  {
+    return details::tls_get (current_<hash_session>::value);
+  }
+
+  inline void hash_session::
+  current_pointer (hash_session* s)
+  {
+    details::tls_set (current_<hash_session>::value, s);
+  }
+
+  inline hash_session& hash_session::
+  current ()
+  {
+    hash_session* s (current_pointer ());
+
+    if (s == 0)
+      throw not_in_session ();
+
+    return *s;
+  }
+
+  template <typename T>
+  inline std::size_t hash_session::
+  type_index ()
+  {
+    static const std::size_t i (
+      details::atomic_add (type_index_<void>::next, 1) - 1);
+    return i;
+  }
+
+  template <typename T>
+  inline void hash_session::
+  cache_erase (const cache_position<T>& p)
+  {
+    if (p.map_ != 0)
+      p.map_->erase (p.id_);
+  }
+
+  template <typename T>
+  inline typename hash_session::cache_position<T> hash_session::
+  _cache_insert (database_type& db,
+                 const typename object_traits<T>::id_type& id,
+                 const typename object_traits<T>::pointer_type& obj)
+  {
+    if (hash_session* s = current_pointer ())
+      return s->cache_insert<T> (db, id, obj);
+    else
+      return cache_position<T> ();
+  }
+
+  template <typename T>
+  inline typename object_traits<T>::pointer_type hash_session::
+  _cache_find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    if (const hash_session* s = current_pointer ())
+      return s->cache_find<T> (db, id);
+    else
+      return pointer_type ();
+  }
+
+  template <typename T>
+  inline void hash_session::
+  _cache_erase (const cache_position<T>& p)
+  {
+    if (p.map_ != 0)
+      p.map_->erase (p.id_);
+  }
+
+  template <typename T>
+  inline void hash_session::
+  _cache_erase (database_type& db,
+                const typename object_traits<T>::id_type& id)
+  {
+    if (hash_session* s = current_pointer ())
+      s->cache_erase<T> (db, id);
+  }
+}
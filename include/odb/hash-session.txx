@@ -0,0 +1,235 @@
+// file      : odb/hash-session.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  //
+  // object_map
+  //
+
+  template <typename T>
+  std::size_t hash_session::object_map<T>::
+  hash (const id_type& id)
+  {
+    // Scramble the bits (MurmurHash3 finalizer) since the id hash can be
+    // as simple as the integer value itself and we use the low bits as
+    // the table index.
+    //
+    std::size_t h (id_hash<id_type> () (id));
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+
+    return h;
+  }
+
+  template <typename T>
+  std::size_t hash_session::object_map<T>::
+  probe (const id_type& id, std::size_t h) const
+  {
+    std::size_t mask (table_.size () - 1);
+
+    for (std::size_t i (h & mask);; i = (i + 1) & mask)
+    {
+      const entry& e (table_[i]);
+
+      if (!e.used || (e.hash == h && e.id == id))
+        return i;
+    }
+  }
+
+  template <typename T>
+  const typename hash_session::object_map<T>::pointer_type*
+  hash_session::object_map<T>::
+  find (const id_type& id) const
+  {
+    if (size_ == 0)
+      return 0;
+
+    const entry& e (table_[probe (id, hash (id))]);
+    return e.used ? &e.obj : 0;
+  }
+
+  template <typename T>
+  void hash_session::object_map<T>::
+  insert (const id_type& id, const pointer_type& obj)
+  {
+    // Keep the load factor under 3/4.
+    //
+    if ((size_ + 1) * 4 > table_.size () * 3)
+      grow ();
+
+    std::size_t h (hash (id));
+    entry& e (table_[probe (id, h)]);
+
+    // In what situation may we possibly attempt to reinsert the object?
+    // See session::cache_insert() for details.
+    //
+    if (!e.used)
+    {
+      e.used = true;
+      e.hash = h;
+      e.id = id;
+      size_++;
+    }
+
+    e.obj = obj;
+  }
+
+  template <typename T>
+  bool hash_session::object_map<T>::
+  erase (const id_type& id)
+  {
+    if (size_ == 0)
+      return false;
+
+    std::size_t mask (table_.size () - 1);
+    std::size_t i (probe (id, hash (id)));
+
+    if (!table_[i].used)
+      return false;
+
+    // Backward shift deletion: move the following entries of the probe
+    // sequence that would no longer be reachable into the hole.
+    //
+    for (std::size_t j (i);;)
+    {
+      j = (j + 1) & mask;
+      entry& e (table_[j]);
+
+      if (!e.used)
+        break;
+
+      std::size_t k (e.hash & mask); // Home index of e.
+
+      // Skip e if its home is cyclically in (i, j].
+      //
+      if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+        continue;
+
+      table_[i] = e;
+      i = j;
+    }
+
+    // Release the object pointer.
+    //
+    table_[i] = entry ();
+    size_--;
+    return true;
+  }
+
+  template <typename T>
+  void hash_session::object_map<T>::
+  grow ()
+  {
+    table t (table_.empty () ? 16 : table_.size () * 2);
+    table_.swap (t);
+
+    std::size_t mask (table_.size () - 1);
+
+    for (typename table::iterator i (t.begin ()); i != t.end (); ++i)
+    {
+      if (!i->used)
+        continue;
+
+      std::size_t j (i->hash & mask);
+
+      while (table_[j].used)
+        j = (j + 1) & mask;
+
+      table_[j] = *i;
+    }
+  }
+
+  //
+  // hash_session
+  //
+
+  template <typename T>
+  hash_session::object_map<T>& hash_session::
+  map (database_type& db)
+  {
+    database_map::iterator di (db_map_.begin ());
+
+    for (; di != db_map_.end () && di->db != &db; ++di) ;
+
+    if (di == db_map_.end ())
+    {
+      database_entry e;
+      e.db = &db;
+      di = db_map_.insert (db_map_.end (), e);
+    }
+
+    type_map& tm (di->types);
+    std::size_t i (type_index<T> ());
+
+    if (i >= tm.size ())
+      tm.resize (i + 1);
+
+    details::shared_ptr<object_map_base>& pom (tm[i]);
+
+    if (!pom)
+      pom.reset (new (details::shared) object_map<T>);
+
+    return static_cast<object_map<T>&> (*pom);
+  }
+
+  template <typename T>
+  hash_session::object_map<T>* hash_session::
+  find_map (database_type& db) const
+  {
+    database_map::const_iterator di (db_map_.begin ());
+
+    for (; di != db_map_.end () && di->db != &db; ++di) ;
+
+    if (di == db_map_.end ())
+      return 0;
+
+    const type_map& tm (di->types);
+    std::size_t i (type_index<T> ());
+
+    if (i >= tm.size () || !tm[i])
+      return 0;
+
+    return static_cast<object_map<T>*> (tm[i].get ());
+  }
+
+  template <typename T>
+  typename hash_session::cache_position<T> hash_session::
+  cache_insert (database_type& db,
+                const typename object_traits<T>::id_type& id,
+                const typename object_traits<T>::pointer_type& obj)
+  {
+    object_map<T>& om (map<T> (db));
+    om.insert (id, obj);
+    return cache_position<T> (om, id);
+  }
+
+  template <typename T>
+  typename object_traits<T>::pointer_type hash_session::
+  cache_find (database_type& db,
+              const typename object_traits<T>::id_type& id) const
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    if (object_map<T>* om = find_map<T> (db))
+    {
+      if (const pointer_type* p = om->find (id))
+        return *p;
+    }
+
+    return pointer_type ();
+  }
+
+  template <typename T>
+  void hash_session::
+  cache_erase (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    if (object_map<T>* om = find_map<T> (db))
+      om->erase (id);
+  }
+}
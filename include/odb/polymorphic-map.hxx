@@ -8,6 +8,8 @@
 #include <odb/pre.hxx>
 
 #include <map>
+#include <string>
+#include <vector>
 #include <utility>  // std::move
 #include <cstddef>  // std::size_t
 #include <cassert>
@@ -15,6 +17,8 @@
 
 #include <odb/callback.hxx>
 
+#include <odb/details/mutex.hxx>
+#include <odb/details/atomic.hxx>
 #include <odb/details/config.hxx>    // ODB_CXX11
 #include <odb/details/type-info.hxx>
 
@@ -22,6 +26,43 @@
 
 namespace odb
 {
+  // Discriminator hashing for the polymorphic_map index. Discriminator
+  // types without a specialization are only looked up in the map.
+  //
+  template <typename D>
+  struct polymorphic_discriminator_hash
+  {
+    static const bool hashable = false;
+
+    static unsigned long long
+    hash (const D&)
+    {
+      return 0;
+    }
+  };
+
+  template <>
+  struct polymorphic_discriminator_hash<std::string>
+  {
+    static const bool hashable = true;
+
+    // FNV-1a.
+    //
+    static unsigned long long
+    hash (const std::string& s)
+    {
+      unsigned long long h (14695981039346656037ULL);
+
+      for (std::string::const_iterator i (s.begin ()); i != s.end (); ++i)
+      {
+        h ^= static_cast<unsigned char> (*i);
+        h *= 1099511628211ULL;
+      }
+
+      return h;
+    }
+  };
+
   template <typename R>
   struct polymorphic_map
   {
@@ -29,7 +70,8 @@ namespace odb
     typedef polymorphic_concrete_info<root_type> info_type;
     typedef typename info_type::discriminator_type discriminator_type;
 
-    polymorphic_map (): ref_count_ (1) {}
+    polymorphic_map (): ref_count_ (1), index_ (0) {}
+    ~polymorphic_map ();
 
     const info_type&
     find (const std::type_info& t) const;
@@ -37,6 +79,15 @@ namespace odb
     const info_type&
     find (const discriminator_type& d) const;
 
+    // Drop the hashed indexes after a registration change. They are
+    // rebuilt from the maps on the next lookup so registering n types
+    // costs O(n) rather than O(n^2). Registration normally only happens
+    // during static initialization and termination and should not be
+    // concurrent with lookups.
+    //
+    void
+    invalidate ();
+
   public:
     typedef
     std::map<const std::type_info*,
@@ -64,6 +115,68 @@ namespace odb
     std::size_t ref_count_;
     type_map type_map_;
     discriminator_map discriminator_map_;
+
+    // Perfect hash indexes over the maps above. Each registered type_info
+    // address and discriminator value hashes to its own slot so a lookup
+    // is one hash computation and one comparison. The type_info index is
+    // keyed by address and a miss falls back to the type map (the same
+    // type can have several type_info objects across shared libraries).
+    // An empty index means that it could not be built and the map is
+    // used instead.
+    //
+    typedef std::vector<const info_type*> slots_type;
+
+    struct index_type
+    {
+      index_type (): type_seed (0), discriminator_seed (0) {}
+
+      slots_type types;
+      std::size_t type_seed;
+
+      slots_type discriminators;
+      std::size_t discriminator_seed;
+    };
+
+  private:
+    polymorphic_map (const polymorphic_map&);
+    polymorphic_map& operator= (const polymorphic_map&);
+
+    // Return the indexes, building them if necessary. Once built, they
+    // are immutable and are read without locking.
+    //
+    const index_type&
+    index () const;
+
+    static std::size_t
+    slot (unsigned long long hash, std::size_t seed, std::size_t mask)
+    {
+      hash ^= seed * 0xff51afd7ed558ccdULL;
+      hash *= 0x9e3779b97f4a7c15ULL;
+      hash ^= hash >> 32;
+      return static_cast<std::size_t> (hash) & mask;
+    }
+
+    static unsigned long long
+    type_hash (const std::type_info& t)
+    {
+      return static_cast<unsigned long long> (
+        reinterpret_cast<std::size_t> (&t));
+    }
+
+    // Find a seed and a power of two size with which the hashes map to
+    // distinct slots and fill the index. Clear the index on failure.
+    //
+    static void
+    build (slots_type&,
+           std::size_t& seed,
+           const std::vector<unsigned long long>& hashes,
+           const std::vector<const info_type*>& infos);
+
+  private:
+    // Built indexes (index_type*) or 0 if they need to be rebuilt.
+    //
+    mutable details::atomic_count index_;
+    mutable details::mutex mutex_;
   };
 
   template <typename R, database_id DB>
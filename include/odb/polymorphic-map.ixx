@@ -4,6 +4,29 @@
 
 namespace odb
 {
+  //
+  // polymorphic_map
+  //
+
+  template <typename R>
+  inline polymorphic_map<R>::
+  ~polymorphic_map ()
+  {
+    invalidate ();
+  }
+
+  template <typename R>
+  inline void polymorphic_map<R>::
+  invalidate ()
+  {
+    delete reinterpret_cast<index_type*> (static_cast<std::size_t> (index_));
+    index_ = 0;
+  }
+
+  //
+  // polymorphic_entry
+  //
+
   template <typename T, database_id DB>
   inline polymorphic_entry<T, DB>::
   polymorphic_entry ()
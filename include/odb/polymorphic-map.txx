@@ -4,6 +4,9 @@
 
 #include <odb/exceptions.hxx> // no_type_info
 
+#include <odb/details/lock.hxx>
+#include <odb/details/unique-ptr.hxx>
+
 namespace odb
 {
   //
@@ -14,6 +17,17 @@ namespace odb
   const typename polymorphic_map<R>::info_type& polymorphic_map<R>::
   find (const std::type_info& t) const
   {
+    const index_type& x (index ());
+
+    if (!x.types.empty ())
+    {
+      const info_type* pi (
+        x.types[slot (type_hash (t), x.type_seed, x.types.size () - 1)]);
+
+      if (pi != 0 && &pi->type == &t)
+        return *pi;
+    }
+
     typename type_map::const_iterator i (type_map_.find (&t));
 
     if (i != type_map_.end ())
@@ -26,6 +40,28 @@ namespace odb
   const typename polymorphic_map<R>::info_type& polymorphic_map<R>::
   find (const discriminator_type& d) const
   {
+    typedef polymorphic_discriminator_hash<discriminator_type> hash_traits;
+
+    const index_type& x (index ());
+
+    if (!x.discriminators.empty ())
+    {
+      // Every registered discriminator has its own slot so if it is not
+      // there, then it is not registered.
+      //
+      const info_type* pi (
+        x.discriminators[slot (hash_traits::hash (d),
+                               x.discriminator_seed,
+                               x.discriminators.size () - 1)]);
+
+      // Discriminators are compared with operator< by the map.
+      //
+      if (pi != 0 && !(pi->discriminator < d) && !(d < pi->discriminator))
+        return *pi;
+      else
+        throw no_type_info ();
+    }
+
     typename discriminator_map::const_iterator i (
       discriminator_map_.find (&d));
 
@@ -35,6 +71,113 @@ namespace odb
       throw no_type_info ();
   }
 
+  template <typename R>
+  const typename polymorphic_map<R>::index_type& polymorphic_map<R>::
+  index () const
+  {
+    typedef polymorphic_discriminator_hash<discriminator_type> hash_traits;
+
+    // Since the index is only accessed through the loaded pointer, a
+    // plain load is sufficient on the supported platforms (see also
+    // shared_cache).
+    //
+    std::size_t p (index_);
+
+    if (p != 0)
+      return *reinterpret_cast<const index_type*> (p);
+
+    details::lock l (mutex_);
+
+    if ((p = index_) != 0)
+      return *reinterpret_cast<const index_type*> (p);
+
+    details::unique_ptr<index_type> x (new index_type);
+
+    std::vector<unsigned long long> hashes;
+    std::vector<const info_type*> infos;
+
+    hashes.reserve (type_map_.size ());
+    infos.reserve (type_map_.size ());
+
+    for (typename type_map::const_iterator i (type_map_.begin ());
+         i != type_map_.end (); ++i)
+    {
+      hashes.push_back (type_hash (*i->first));
+      infos.push_back (i->second);
+    }
+
+    build (x->types, x->type_seed, hashes, infos);
+
+    if (hash_traits::hashable)
+    {
+      hashes.clear ();
+      infos.clear ();
+
+      for (typename discriminator_map::const_iterator i (
+             discriminator_map_.begin ()); i != discriminator_map_.end (); ++i)
+      {
+        hashes.push_back (hash_traits::hash (*i->first));
+        infos.push_back (i->second);
+      }
+
+      build (x->discriminators, x->discriminator_seed, hashes, infos);
+    }
+
+    // Publish with a full memory barrier.
+    //
+    details::atomic_cas (index_, 0, reinterpret_cast<std::size_t> (x.get ()));
+    return *x.release ();
+  }
+
+  template <typename R>
+  void polymorphic_map<R>::
+  build (slots_type& index,
+         std::size_t& seed,
+         const std::vector<unsigned long long>& hashes,
+         const std::vector<const info_type*>& infos)
+  {
+    std::size_t n (hashes.size ());
+
+    index.clear ();
+
+    if (n == 0)
+      return;
+
+    // Start with a load factor of at most 1/2 and give up once the index
+    // is unreasonably sparse.
+    //
+    std::size_t size (2);
+    while (size < 2 * n)
+      size *= 2;
+
+    for (; size <= 64 * n; size *= 2)
+    {
+      for (std::size_t s (0); s != 32; ++s)
+      {
+        index.assign (size, 0);
+
+        std::size_t i (0);
+        for (; i != n; ++i)
+        {
+          const info_type*& pi (index[slot (hashes[i], s, size - 1)]);
+
+          if (pi != 0)
+            break;
+
+          pi = infos[i];
+        }
+
+        if (i == n)
+        {
+          seed = s;
+          return;
+        }
+      }
+    }
+
+    index.clear ();
+  }
+
   //
   // polymorphic_entry_impl
   //
@@ -54,6 +197,7 @@ namespace odb
 
     pm->type_map_[&i.type] = &i;
     pm->discriminator_map_[&i.discriminator] = &i;
+    pm->invalidate ();
   }
 
   template <typename R, database_id DB>
@@ -72,5 +216,7 @@ namespace odb
       delete pm;
       pm = 0;
     }
+    else
+      pm->invalidate ();
   }
 }
@@ -0,0 +1,469 @@
+// file      : odb/shared-cache.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SHARED_CACHE_HXX
+#define ODB_SHARED_CACHE_HXX
+
+#include <odb/pre.hxx>
+
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/traits.hxx>
+#include <odb/forward.hxx>
+#include <odb/hash-session.hxx> // id_hash
+
+#include <odb/details/mutex.hxx>
+#include <odb/details/atomic.hxx>
+
+namespace odb
+{
+  // Specialize this template with value set to true to enable the
+  // shared cache for an object type. Such a type should be copy-
+  // constructible, non-polymorphic, and should not contain pointers to
+  // other objects since its instances are copied between threads.
+  //
+  template <typename T>
+  struct shared_cacheable
+  {
+    static const bool value = false;
+  };
+
+  // Process-wide object cache shared by all the threads. It holds
+  // immutable snapshots of loaded objects and a lookup returns a private
+  // copy of the snapshot. The cache is divided into shards, each with a
+  // hash table that is read without locking and modified under the
+  // shard's mutex. The replaced parts of the table are retired in
+  // epochs and freed once all the readers that entered the shard during
+  // the epoch have left it.
+  //
+  // A snapshot is dropped when its object is updated or erased and then
+  // again when the transaction that did it is committed. Snapshots
+  // loaded by a transaction are not stored if anything was invalidated
+  // since this transaction began. The cache should outlive all the
+  // transactions that use it.
+  //
+  // The cache is normally used behind the shared_cache_session session
+  // type with the process-wide instance set with instance(). For
+  // example:
+  //
+  // odb::shared_cache sc;
+  // odb::shared_cache::instance (&sc);
+  //
+  class shared_cache
+  {
+  public:
+    typedef odb::database database_type;
+
+    struct statistics_type
+    {
+      std::size_t hits;
+      std::size_t misses;
+      std::size_t invalidations;
+      std::size_t size;
+    };
+
+    // The number of shards is rounded up to a power of two.
+    //
+    explicit
+    shared_cache (std::size_t shards = 16);
+
+    ~shared_cache ();
+
+    // Process-wide instance. It should be set before and reset after
+    // the threads that use it.
+    //
+    static shared_cache*
+    instance ();
+
+    static void
+    instance (shared_cache*);
+
+    // Return a new copy of the cached object or NULL if there is none.
+    //
+    template <typename T>
+    typename object_traits<T>::pointer_type
+    find (database_type&, const typename object_traits<T>::id_type&);
+
+    // Return the current invalidation generation. It is incremented
+    // every time a snapshot is dropped.
+    //
+    std::size_t
+    generation ();
+
+    static const std::size_t no_generation = ~static_cast<std::size_t> (0);
+
+    // Store a snapshot of the object unless anything was invalidated
+    // since the generation was obtained. Nothing is stored for the
+    // no_generation value.
+    //
+    template <typename T>
+    void
+    insert (database_type&,
+            const typename object_traits<T>::id_type&,
+            const T&,
+            std::size_t generation);
+
+    // Drop the snapshot of the object.
+    //
+    template <typename T>
+    void
+    erase (database_type&, const typename object_traits<T>::id_type&);
+
+    // Drop the snapshot of the object now and, if there is a current
+    // transaction, once it is committed.
+    //
+    template <typename T>
+    void
+    invalidate (database_type&, const typename object_traits<T>::id_type&);
+
+    void
+    clear ();
+
+    statistics_type
+    statistics () const;
+
+  private:
+    shared_cache (const shared_cache&);
+    shared_cache& operator= (const shared_cache&);
+
+  private:
+    // Cached object. Immutable once inserted.
+    //
+    struct node
+    {
+      virtual
+      ~node () {}
+
+      std::size_t hash;
+      database_type* db;
+      std::size_t type;
+    };
+
+    template <typename T>
+    struct object_node: node
+    {
+      typedef typename object_traits<T>::id_type id_type;
+
+      object_node (const id_type& i, const T& o): id (i), object (o) {}
+
+      id_type id;
+      T object;
+    };
+
+    // Bucket chains and tables are immutable once published and are
+    // replaced rather than modified.
+    //
+    typedef std::vector<node*> chain;
+
+    struct table
+    {
+      table (std::size_t n);
+      ~table ();
+
+      std::size_t mask;
+      details::atomic_count* buckets; // chain*
+    };
+
+    struct retired_list
+    {
+      std::vector<node*> nodes;
+      std::vector<chain*> chains;
+      std::vector<table*> tables;
+    };
+
+    // Readers are counted separately for even and odd epochs. What is
+    // retired during an epoch can only be referenced by the readers of
+    // this and earlier epochs. So once the epoch is advanced, the
+    // readers of the previous one drain even under a steady stream of
+    // new readers.
+    //
+    struct shard
+    {
+      shard ();
+      ~shard ();
+
+      details::atomic_count epoch;      // Modified under mutex.
+      details::atomic_count readers[2]; // Indexed by epoch parity.
+      details::atomic_count hits;
+      details::atomic_count misses;
+      details::atomic_count root; // table*
+
+      // Protected by mutex.
+      //
+      std::size_t size;
+      retired_list retired[2]; // Indexed by epoch parity.
+
+      details::mutex mutex;
+    };
+
+    struct reader
+    {
+      reader (shard&);
+      ~reader () {details::atomic_sub (*count_, 1);}
+
+    private:
+      details::atomic_count* count_;
+    };
+
+    // Pending invalidation registered as a transaction callback.
+    //
+    struct invalidation_base
+    {
+      virtual
+      ~invalidation_base () {}
+
+      virtual void
+      apply () = 0;
+    };
+
+    template <typename T>
+    struct invalidation: invalidation_base
+    {
+      typedef typename object_traits<T>::id_type id_type;
+
+      invalidation (shared_cache& c, database_type& d, const id_type& i)
+          : cache (c), db (d), id (i) {}
+
+      virtual void
+      apply () {cache.erase<T> (db, id);}
+
+      shared_cache& cache;
+      database_type& db;
+      id_type id;
+    };
+
+    static void
+    commit (unsigned short, void* key, unsigned long long);
+
+    // Pointers are stored in atomic_count variables. Since readers only
+    // access memory through the loaded pointer, a plain load is
+    // sufficient on the supported platforms.
+    //
+    template <typename P>
+    static P*
+    load (const details::atomic_count& x)
+    {
+      return reinterpret_cast<P*> (static_cast<std::size_t> (x));
+    }
+
+    // Publish the pointer. Must be called with the shard's mutex held.
+    //
+    static void
+    store (details::atomic_count&, const void*);
+
+    template <typename T>
+    static std::size_t
+    type_index ();
+
+    template <typename T>
+    static std::size_t
+    hash (database_type&, const typename object_traits<T>::id_type&);
+
+    shard&
+    find_shard (std::size_t hash) const;
+
+    template <typename T>
+    static bool
+    match (const node&,
+           std::size_t hash,
+           database_type&,
+           const typename object_traits<T>::id_type&);
+
+    // Replace the bucket's chain with the one without the object's node
+    // and with n added, if not NULL. Return true if a node was removed.
+    // Must be called with the shard's mutex held.
+    //
+    template <typename T>
+    bool
+    replace (shard&,
+             std::size_t hash,
+             database_type&,
+             const typename object_traits<T>::id_type&,
+             node* n);
+
+    // Replace the table with the one that has twice as many buckets.
+    // Must be called with the shard's mutex held.
+    //
+    void
+    rehash (shard&);
+
+    // Make sure that n more elements can be added without reallocation.
+    //
+    template <typename X>
+    static void
+    reserve (std::vector<X>&, std::size_t n);
+
+    // Return the list for the current epoch. Must be called with the
+    // shard's mutex held.
+    //
+    static retired_list&
+    retired (shard&);
+
+    // Retire the table with all its chains and nodes. Must be called
+    // with the shard's mutex held.
+    //
+    static void
+    retire (shard&);
+
+    // Free what was retired during the previous epoch if all its
+    // readers have left and advance the epoch if anything was retired
+    // during the current one. Must be called with the shard's mutex
+    // held.
+    //
+    static void
+    reclaim (shard&);
+
+    static void
+    dispose (retired_list&);
+
+    template <typename S>
+    struct instance_
+    {
+      static S* value;
+    };
+
+    template <typename S>
+    struct type_index_
+    {
+      static details::atomic_count next;
+    };
+
+  private:
+    std::size_t shard_bits_;
+    shard* shards_;
+
+    details::atomic_count generation_;
+    details::atomic_count invalidations_;
+  };
+
+  // Session with the per-thread object cache of hash_session backed by
+  // the process-wide shared cache. Objects of shared_cacheable types
+  // that are not in the session are looked up in the shared cache and
+  // objects loaded into the session are added to it. Updating or
+  // erasing such objects invalidates their snapshots even if there is
+  // no current session. Objects changed with erase_query() or native
+  // statements are not invalidated automatically; use erase() or clear()
+  // on the shared cache for them.
+  //
+  // This session type is selected with the --session-type ODB compiler
+  // option (or the session pragma). Its current session is independent
+  // of that of hash_session.
+  //
+  class shared_cache_session: public hash_session
+  {
+  public:
+    shared_cache_session (bool make_current = true);
+
+    ~shared_cache_session ();
+
+    // Current session.
+    //
+  public:
+    static bool
+    has_current () {return current_pointer () != 0;}
+
+    // Get current thread's session. Throw if no session is in effect.
+    //
+    static shared_cache_session&
+    current ();
+
+    static void
+    current (shared_cache_session& s) {current_pointer (&s);}
+
+    static void
+    reset_current () {current_pointer (0);}
+
+    static shared_cache_session*
+    current_pointer ();
+
+    static void
+    current_pointer (shared_cache_session*);
+
+    // Static cache API as expected by the rest of ODB.
+    //
+  public:
+    template <typename T>
+    struct cache_position: hash_session::cache_position<T>
+    {
+      typedef hash_session::cache_position<T> base;
+
+      cache_position (): db_ (0), generation_ (0) {}
+      cache_position (const base& p, database_type& db, std::size_t g)
+          : base (p), db_ (&db), generation_ (g) {}
+
+      database_type* db_;
+      std::size_t generation_;
+    };
+
+    template <typename T>
+    static cache_position<T>
+    _cache_insert (database_type&,
+                   const typename object_traits<T>::id_type&,
+                   const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    static typename object_traits<T>::pointer_type
+    _cache_find (database_type&, const typename object_traits<T>::id_type&);
+
+    template <typename T>
+    static void
+    _cache_erase (const cache_position<T>& p)
+    {
+      hash_session::_cache_erase<T> (p);
+    }
+
+    template <typename T>
+    static void
+    _cache_persist (const cache_position<T>&) {}
+
+    template <typename T>
+    static void
+    _cache_load (const cache_position<T>&);
+
+    template <typename T>
+    static void
+    _cache_update (database_type&, const T&);
+
+    template <typename T>
+    static void
+    _cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+  private:
+    shared_cache_session (const shared_cache_session&);
+    shared_cache_session& operator= (const shared_cache_session&);
+
+  private:
+    template <typename T>
+    static shared_cache*
+    cache ();
+
+    // Return the cache generation as of the beginning of the current
+    // transaction or no_generation if it is unknown.
+    //
+    std::size_t
+    generation (shared_cache&);
+
+    static void
+    reset (unsigned short, void*, unsigned long long);
+
+  private:
+    odb::transaction* tran_;
+    std::size_t generation_;
+
+    // We cannot observe the beginning of a transaction. Instead, we
+    // use the generation as of the end of the previous transaction that
+    // accessed the cache (or the creation of the session) which is the
+    // same or older.
+    //
+    std::size_t start_;
+  };
+}
+
+#include <odb/shared-cache.ixx>
+#include <odb/shared-cache.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SHARED_CACHE_HXX
@@ -0,0 +1,433 @@
+// file      : odb/shared-cache.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/exceptions.hxx>
+#include <odb/transaction.hxx>
+
+#include <odb/details/lock.hxx>
+#include <odb/details/unique-ptr.hxx>
+
+namespace odb
+{
+  template <typename S>
+  S* shared_cache::instance_<S>::value = 0;
+
+  template <typename S>
+  details::atomic_count shared_cache::type_index_<S>::next = 0;
+
+  //
+  // table
+  //
+
+  inline shared_cache::table::
+  table (std::size_t n)
+      : mask (n - 1), buckets (new details::atomic_count[n])
+  {
+    for (std::size_t i (0); i != n; ++i)
+      buckets[i] = 0;
+  }
+
+  inline shared_cache::table::
+  ~table ()
+  {
+    delete[] buckets;
+  }
+
+  //
+  // shard
+  //
+
+  inline shared_cache::shard::
+  shard ()
+      : epoch (0), hits (0), misses (0), root (0), size (0)
+  {
+    readers[0] = 0;
+    readers[1] = 0;
+  }
+
+  inline shared_cache::shard::
+  ~shard ()
+  {
+    retire (*this);
+    dispose (retired[0]);
+    dispose (retired[1]);
+  }
+
+  //
+  // reader
+  //
+
+  inline shared_cache::reader::
+  reader (shard& s)
+  {
+    // If the epoch has changed while we were registering, then we may
+    // have been counted after the writer checked this count. Register
+    // with the new epoch instead.
+    //
+    for (;;)
+    {
+      std::size_t e (details::atomic_load (s.epoch));
+      count_ = &s.readers[e & 1];
+      details::atomic_add (*count_, 1);
+
+      if (details::atomic_load (s.epoch) == e)
+        break;
+
+      details::atomic_sub (*count_, 1);
+    }
+  }
+
+  //
+  // shared_cache
+  //
+
+  inline shared_cache::
+  shared_cache (std::size_t shards)
+      : shard_bits_ (0), generation_ (0), invalidations_ (0)
+  {
+    while ((static_cast<std::size_t> (1) << shard_bits_) < shards)
+      shard_bits_++;
+
+    shards_ = new shard[static_cast<std::size_t> (1) << shard_bits_];
+  }
+
+  inline shared_cache::
+  ~shared_cache ()
+  {
+    if (instance () == this)
+      instance (0);
+
+    delete[] shards_;
+  }
+
+  inline shared_cache* shared_cache::
+  instance ()
+  {
+    return instance_<shared_cache>::value;
+  }
+
+  inline void shared_cache::
+  instance (shared_cache* c)
+  {
+    instance_<shared_cache>::value = c;
+  }
+
+  inline std::size_t shared_cache::
+  generation ()
+  {
+    return details::atomic_load (generation_);
+  }
+
+  inline shared_cache::shard& shared_cache::
+  find_shard (std::size_t h) const
+  {
+    return shards_[h & ((static_cast<std::size_t> (1) << shard_bits_) - 1)];
+  }
+
+  inline void shared_cache::
+  store (details::atomic_count& x, const void* p)
+  {
+    // The value cannot change concurrently so this succeeds on the first
+    // attempt. We use it for the memory barrier.
+    //
+    std::size_t o (x);
+    details::atomic_cas (x, o, reinterpret_cast<std::size_t> (p));
+  }
+
+  inline shared_cache::retired_list& shared_cache::
+  retired (shard& s)
+  {
+    return s.retired[s.epoch & 1];
+  }
+
+  inline void shared_cache::
+  dispose (retired_list& r)
+  {
+    for (std::vector<table*>::iterator i (r.tables.begin ());
+         i != r.tables.end ();
+         ++i)
+      delete *i;
+
+    for (std::vector<chain*>::iterator i (r.chains.begin ());
+         i != r.chains.end ();
+         ++i)
+      delete *i;
+
+    for (std::vector<node*>::iterator i (r.nodes.begin ());
+         i != r.nodes.end ();
+         ++i)
+      delete *i;
+
+    r.tables.clear ();
+    r.chains.clear ();
+    r.nodes.clear ();
+  }
+
+  inline void shared_cache::
+  reclaim (shard& s)
+  {
+    // The readers of the current epoch registered after everything
+    // retired during the previous one was unpublished.
+    //
+    std::size_t p ((s.epoch & 1) ^ 1);
+
+    if (details::atomic_load (s.readers[p]) != 0)
+      return;
+
+    dispose (s.retired[p]);
+
+    retired_list& c (retired (s));
+
+    if (!c.tables.empty () || !c.chains.empty () || !c.nodes.empty ())
+      details::atomic_add (s.epoch, 1);
+  }
+
+  inline void shared_cache::
+  retire (shard& s)
+  {
+    table* t (load<table> (s.root));
+
+    if (t == 0)
+      return;
+
+    std::size_t n (t->mask + 1), cn (0), nn (0);
+
+    for (std::size_t i (0); i != n; ++i)
+    {
+      if (chain* c = load<chain> (t->buckets[i]))
+      {
+        cn++;
+        nn += c->size ();
+      }
+    }
+
+    // Nothing should throw once the table is unpublished.
+    //
+    retired_list& r (retired (s));
+    reserve (r.tables, 1);
+    reserve (r.chains, cn);
+    reserve (r.nodes, nn);
+
+    store (s.root, 0);
+    r.tables.push_back (t);
+
+    for (std::size_t i (0); i != n; ++i)
+    {
+      if (chain* c = load<chain> (t->buckets[i]))
+      {
+        r.chains.push_back (c);
+        r.nodes.insert (r.nodes.end (), c->begin (), c->end ());
+      }
+    }
+
+    s.size = 0;
+  }
+
+  inline void shared_cache::
+  rehash (shard& s)
+  {
+    table* t (load<table> (s.root));
+    std::size_t n (t->mask + 1);
+
+    details::unique_ptr<table> nt (new table (2 * n));
+    std::vector<chain*> cs (2 * n, static_cast<chain*> (0));
+
+    try
+    {
+      for (std::size_t i (0); i != n; ++i)
+      {
+        if (chain* c = load<chain> (t->buckets[i]))
+        {
+          for (chain::const_iterator j (c->begin ()); j != c->end (); ++j)
+          {
+            chain*& nc (cs[((*j)->hash >> shard_bits_) & nt->mask]);
+
+            if (nc == 0)
+              nc = new chain;
+
+            nc->push_back (*j);
+          }
+        }
+      }
+
+      reserve (retired (s).tables, 1);
+      reserve (retired (s).chains, n);
+    }
+    catch (...)
+    {
+      for (std::size_t i (0); i != cs.size (); ++i)
+        delete cs[i];
+
+      throw;
+    }
+
+    // The nodes are moved to the new table, only the old table and its
+    // chains are retired.
+    //
+    for (std::size_t i (0); i != cs.size (); ++i)
+      nt->buckets[i] = reinterpret_cast<std::size_t> (cs[i]);
+
+    store (s.root, nt.release ());
+
+    retired_list& r (retired (s));
+    r.tables.push_back (t);
+
+    for (std::size_t i (0); i != n; ++i)
+    {
+      if (chain* c = load<chain> (t->buckets[i]))
+        r.chains.push_back (c);
+    }
+  }
+
+  inline void shared_cache::
+  clear ()
+  {
+    std::size_t n (static_cast<std::size_t> (1) << shard_bits_);
+
+    for (std::size_t i (0); i != n; ++i)
+    {
+      shard& s (shards_[i]);
+      details::lock l (s.mutex);
+
+      details::atomic_add (generation_, 1);
+      retire (s);
+      reclaim (s);
+    }
+  }
+
+  inline shared_cache::statistics_type shared_cache::
+  statistics () const
+  {
+    statistics_type r;
+    r.hits = 0;
+    r.misses = 0;
+    r.invalidations = invalidations_;
+    r.size = 0;
+
+    std::size_t n (static_cast<std::size_t> (1) << shard_bits_);
+
+    for (std::size_t i (0); i != n; ++i)
+    {
+      shard& s (shards_[i]);
+      r.hits += s.hits;
+      r.misses += s.misses;
+
+      details::lock l (s.mutex);
+      r.size += s.size;
+    }
+
+    return r;
+  }
+
+  inline void shared_cache::
+  commit (unsigned short event, void* key, unsigned long long)
+  {
+    details::unique_ptr<invalidation_base> i (
+      static_cast<invalidation_base*> (key));
+
+    if (event == transaction::event_commit)
+      i->apply ();
+  }
+
+  //
+  // shared_cache_session
+  //
+
+  inline shared_cache_session::
+  shared_cache_session (bool make_current)
+      : hash_session (false), tran_ (0), generation_ (0), start_ (0)
+  {
+    shared_cache* c (shared_cache::instance ());
+
+    if (c != 0)
+      start_ = c->generation ();
+
+    // We don't know when the current transaction, if any, has begun
+    // so don't store anything it loads.
+    //
+    if (transaction::has_current ())
+    {
+      tran_ = &transaction::current ();
+      tran_->callback_register (
+        &reset, this, transaction::event_all, 0, &tran_);
+      generation_ = shared_cache::no_generation;
+    }
+
+    if (make_current)
+    {
+      if (has_current ())
+        throw already_in_session ();
+
+      current_pointer (this);
+    }
+  }
+
+  inline shared_cache_session::
+  ~shared_cache_session ()
+  {
+    if (tran_ != 0)
+      tran_->callback_unregister (this);
+
+    // If we are the current thread's session, reset it.
+    //
+    if (current_pointer () == this)
+      reset_current ();
+  }
+
+  inline shared_cache_session* shared_cache_session::
+  current_pointer ()
+  {
+    return details::tls_get (current_<shared_cache_session>::value);
+  }
+
+  inline void shared_cache_session::
+  current_pointer (shared_cache_session* s)
+  {
+    details::tls_set (current_<shared_cache_session>::value, s);
+  }
+
+  inline shared_cache_session& shared_cache_session::
+  current ()
+  {
+    shared_cache_session* s (current_pointer ());
+
+    if (s == 0)
+      throw not_in_session ();
+
+    return *s;
+  }
+
+  inline std::size_t shared_cache_session::
+  generation (shared_cache& c)
+  {
+    if (tran_ == 0 && transaction::has_current ())
+    {
+      tran_ = &transaction::current ();
+      tran_->callback_register (
+        &reset, this, transaction::event_all, 0, &tran_);
+      generation_ = start_;
+    }
+
+    return tran_ != 0 ? generation_ : c.generation ();
+  }
+
+  inline void shared_cache_session::
+  reset (unsigned short, void* key, unsigned long long)
+  {
+    // The next transaction begins after this point.
+    //
+    shared_cache_session& s (*static_cast<shared_cache_session*> (key));
+    shared_cache* c (shared_cache::instance ());
+    s.start_ = c != 0 ? c->generation () : 0;
+  }
+
+  template <typename T>
+  inline shared_cache* shared_cache_session::
+  cache ()
+  {
+    return shared_cacheable<T>::value && !object_traits<T>::polymorphic
+      ? shared_cache::instance ()
+      : 0;
+  }
+}
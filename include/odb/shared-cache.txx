@@ -0,0 +1,336 @@
+// file      : odb/shared-cache.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/pointer-traits.hxx>
+
+namespace odb
+{
+  //
+  // shared_cache
+  //
+
+  template <typename T>
+  std::size_t shared_cache::
+  type_index ()
+  {
+    static const std::size_t i (
+      details::atomic_add (type_index_<void>::next, 1) - 1);
+    return i;
+  }
+
+  template <typename T>
+  std::size_t shared_cache::
+  hash (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::id_type id_type;
+
+    std::size_t h (id_hash<id_type> () (id));
+    h ^= reinterpret_cast<std::size_t> (&db) >> 4;
+    h += type_index<T> () * 0x9e3779b9U;
+
+    // Scramble the bits (MurmurHash3 finalizer) since the low bits
+    // select the shard and the following ones the bucket.
+    //
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+
+    return h;
+  }
+
+  template <typename T>
+  bool shared_cache::
+  match (const node& n,
+         std::size_t h,
+         database_type& db,
+         const typename object_traits<T>::id_type& id)
+  {
+    return n.hash == h &&
+      n.db == &db &&
+      n.type == type_index<T> () &&
+      static_cast<const object_node<T>&> (n).id == id;
+  }
+
+  template <typename T>
+  typename object_traits<T>::pointer_type shared_cache::
+  find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    std::size_t h (hash<T> (db, id));
+    shard& s (find_shard (h));
+
+    {
+      reader r (s);
+
+      table* t (load<table> (s.root));
+      chain* c (t != 0
+                ? load<chain> (t->buckets[(h >> shard_bits_) & t->mask])
+                : 0);
+
+      if (c != 0)
+      {
+        for (chain::const_iterator i (c->begin ()); i != c->end (); ++i)
+        {
+          if (match<T> (**i, h, db, id))
+          {
+            pointer_type p (
+              new T (static_cast<const object_node<T>&> (**i).object));
+
+            details::atomic_add (s.hits, 1);
+            return p;
+          }
+        }
+      }
+    }
+
+    details::atomic_add (s.misses, 1);
+    return pointer_type ();
+  }
+
+  template <typename T>
+  void shared_cache::
+  insert (database_type& db,
+          const typename object_traits<T>::id_type& id,
+          const T& obj,
+          std::size_t g)
+  {
+    std::size_t h (hash<T> (db, id));
+    shard& s (find_shard (h));
+
+    // Invalidations of this object happen with the same mutex held.
+    //
+    details::lock l (s.mutex);
+
+    if (g == no_generation || details::atomic_load (generation_) != g)
+      return;
+
+    details::unique_ptr<object_node<T> > n (new object_node<T> (id, obj));
+    n->hash = h;
+    n->db = &db;
+    n->type = type_index<T> ();
+
+    replace<T> (s, h, db, id, n.get ());
+    n.release ();
+
+    reclaim (s);
+  }
+
+  template <typename T>
+  void shared_cache::
+  erase (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    std::size_t h (hash<T> (db, id));
+    shard& s (find_shard (h));
+
+    details::lock l (s.mutex);
+
+    // Prevent snapshots that are being loaded from being stored.
+    //
+    details::atomic_add (generation_, 1);
+
+    if (replace<T> (s, h, db, id, 0))
+      details::atomic_add (invalidations_, 1);
+
+    reclaim (s);
+  }
+
+  template <typename T>
+  void shared_cache::
+  invalidate (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    erase<T> (db, id);
+
+    // Other transactions can load and store the old state until this
+    // one is committed.
+    //
+    if (transaction::has_current ())
+    {
+      details::unique_ptr<invalidation_base> i (
+        new invalidation<T> (*this, db, id));
+
+      transaction::current ().callback_register (&commit, i.get ());
+      i.release ();
+    }
+  }
+
+  template <typename T>
+  bool shared_cache::
+  replace (shard& s,
+           std::size_t h,
+           database_type& db,
+           const typename object_traits<T>::id_type& id,
+           node* n)
+  {
+    table* t (load<table> (s.root));
+
+    if (t == 0)
+    {
+      if (n == 0)
+        return false;
+
+      t = new table (8);
+      store (s.root, t);
+    }
+    else if (n != 0 && s.size >= 2 * (t->mask + 1))
+    {
+      // Keep the average chain length under 2.
+      //
+      rehash (s);
+      t = load<table> (s.root);
+    }
+
+    details::atomic_count& b (t->buckets[(h >> shard_bits_) & t->mask]);
+    chain* c (load<chain> (b));
+
+    node* old (0);
+    details::unique_ptr<chain> nc (new chain);
+
+    if (c != 0)
+    {
+      nc->reserve (c->size () + 1);
+
+      for (chain::const_iterator i (c->begin ()); i != c->end (); ++i)
+      {
+        if (old == 0 && match<T> (**i, h, db, id))
+          old = *i;
+        else
+          nc->push_back (*i);
+      }
+    }
+
+    if (old == 0 && n == 0)
+      return false;
+
+    if (n != 0)
+      nc->push_back (n);
+
+    // Nothing should throw once the new chain is published.
+    //
+    retired_list& r (retired (s));
+    reserve (r.chains, 1);
+    reserve (r.nodes, 1);
+
+    store (b, nc->empty () ? 0 : nc.release ());
+
+    if (c != 0)
+      r.chains.push_back (c);
+
+    if (old != 0)
+    {
+      r.nodes.push_back (old);
+      s.size--;
+    }
+
+    if (n != 0)
+      s.size++;
+
+    return old != 0;
+  }
+
+  template <typename X>
+  void shared_cache::
+  reserve (std::vector<X>& v, std::size_t n)
+  {
+    if (v.capacity () - v.size () < n)
+      v.reserve (2 * v.size () + n);
+  }
+
+  //
+  // shared_cache_session
+  //
+
+  template <typename T>
+  typename shared_cache_session::cache_position<T> shared_cache_session::
+  _cache_insert (database_type& db,
+                 const typename object_traits<T>::id_type& id,
+                 const typename object_traits<T>::pointer_type& obj)
+  {
+    shared_cache_session* s (current_pointer ());
+
+    if (s == 0)
+      return cache_position<T> ();
+
+    shared_cache* c (cache<T> ());
+
+    return cache_position<T> (
+      s->cache_insert<T> (db, id, obj), db, c != 0 ? s->generation (*c) : 0);
+  }
+
+  template <typename T>
+  typename object_traits<T>::pointer_type shared_cache_session::
+  _cache_find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    shared_cache_session* s (current_pointer ());
+
+    if (s != 0)
+    {
+      pointer_type p (s->cache_find<T> (db, id));
+
+      if (!pointer_traits::null_ptr (p))
+        return p;
+    }
+
+    shared_cache* c (cache<T> ());
+
+    if (c == 0)
+      return pointer_type ();
+
+    // Capture the generation before the object is loaded from the
+    // database.
+    //
+    if (s != 0)
+      s->generation (*c);
+
+    pointer_type p (c->find<T> (db, id));
+
+    if (s != 0 && !pointer_traits::null_ptr (p))
+      s->cache_insert<T> (db, id, p);
+
+    return p;
+  }
+
+  template <typename T>
+  void shared_cache_session::
+  _cache_load (const cache_position<T>& p)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+    typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+    if (p.map_ == 0)
+      return;
+
+    if (shared_cache* c = cache<T> ())
+    {
+      if (const pointer_type* o = p.map_->find (p.id_))
+        c->insert<T> (
+          *p.db_, p.id_, pointer_traits::get_ref (*o), p.generation_);
+    }
+  }
+
+  template <typename T>
+  void shared_cache_session::
+  _cache_update (database_type& db, const T& obj)
+  {
+    if (shared_cache* c = cache<T> ())
+      c->invalidate<T> (db, object_traits<T>::id (obj));
+  }
+
+  template <typename T>
+  void shared_cache_session::
+  _cache_erase (database_type& db,
+                const typename object_traits<T>::id_type& id)
+  {
+    if (shared_cache_session* s = current_pointer ())
+      s->cache_erase<T> (db, id);
+
+    if (shared_cache* c = cache<T> ())
+      c->invalidate<T> (db, id);
+  }
+}
@@ -0,0 +1,198 @@
+// file      : odb/sqlite/affine-connection-factory.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_AFFINE_CONNECTION_FACTORY_HXX
+#define ODB_SQLITE_AFFINE_CONNECTION_FACTORY_HXX
+
+#include <odb/pre.hxx>
+
+#include <cstddef> // std::size_t
+#include <cassert>
+
+#include <odb/details/tls.hxx>
+#include <odb/details/mutex.hxx>
+#include <odb/details/atomic.hxx>
+#include <odb/details/condition.hxx>
+#include <odb/details/shared-ptr.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/connection-factory.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Pool a fixed maximum number of connections without serializing
+    // every connect() and release() on a mutex (as connection_pool_factory
+    // does). Idle connections are handed out from a lock-free slot array
+    // and each thread first tries to get back the connection it used last
+    // (and thus its warm statement cache). The mutex and condition are
+    // only used when all the connections are in use and the thread has
+    // to wait for one to be released.
+    //
+    class affine_connection_pool_factory: public connection_factory
+    {
+    public:
+      // The max_connections argument specifies the maximum number of
+      // concurrent connections this pool will maintain and should not
+      // be 0. Connections are created on demand and are kept until the
+      // pool is destroyed.
+      //
+      explicit
+      affine_connection_pool_factory (std::size_t max_connections);
+
+      virtual connection_ptr
+      connect ();
+
+      virtual void
+      database (database_type&);
+
+      virtual
+      ~affine_connection_pool_factory ();
+
+      // Pool statistics. A hit is a connection returned from the calling
+      // thread's affinity slot while a miss is any other connection,
+      // either idle or newly created. The wait time is in microseconds
+      // and is only tracked if a suitable clock is available.
+      //
+    public:
+      struct statistics_type
+      {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t waits;
+        unsigned long long wait_time;
+      };
+
+      statistics_type
+      statistics ();
+
+    private:
+      affine_connection_pool_factory (const affine_connection_pool_factory&);
+      affine_connection_pool_factory&
+      operator= (const affine_connection_pool_factory&);
+
+    protected:
+      class pooled_connection;
+
+      struct slot
+      {
+        enum state_type
+        {
+          empty, // No connection yet.
+          idle,  // Connection is available.
+          busy   // Connection is in use or is being created.
+        };
+
+        details::atomic_count state;
+        pooled_connection* connection;
+      };
+
+      class pooled_connection: public connection
+      {
+      public:
+        pooled_connection (database_type&, int extra_flags = 0);
+        pooled_connection (database_type&, sqlite3*);
+
+      private:
+        static bool
+        zero_counter (void*);
+
+      private:
+        friend class affine_connection_pool_factory;
+
+        shared_base::refcount_callback callback_;
+
+        affine_connection_pool_factory* pool_;
+        slot* slot_;
+      };
+
+      friend class pooled_connection;
+
+      typedef details::shared_ptr<pooled_connection> pooled_connection_ptr;
+
+      // This function is called whenever the pool needs to create a new
+      // connection.
+      //
+      virtual pooled_connection_ptr
+      create ();
+
+    protected:
+      // Per-thread pointer to the slot last used by this thread. It is
+      // only compared to this pool's slots and never dereferenced
+      // otherwise so it can safely refer to a slot of another (or an
+      // already destroyed) pool. The K argument distinguishes between
+      // the variables of pools that are used by the same threads (see
+      // hint() below). This is a template only to allow the definition
+      // in the header.
+      //
+      template <typename S, typename K = S>
+      struct thread_hint
+      {
+        static ODB_TLS_POINTER (S) value;
+      };
+
+      // Get and set the calling thread's hint for this pool. By default
+      // all the pools share the same variable so a thread that uses
+      // several of them alternately keeps only the last one's affinity.
+      // Override to use a separate variable for such pools.
+      //
+      virtual slot*
+      hint () const;
+
+      virtual void
+      hint (slot*);
+
+      // Try to acquire a slot with an idle connection or an empty slot
+      // without blocking. Return NULL if all the slots are busy.
+      //
+      slot*
+      acquire ();
+
+      // Hand out the connection from the acquired slot, creating it if
+      // necessary.
+      //
+      connection_ptr
+      activate (slot&, bool hit);
+
+      bool
+      owns (const slot*) const;
+
+      // Return true if the connection should be deleted, false otherwise.
+      //
+      bool
+      release (pooled_connection*);
+
+      static unsigned long long
+      now ();
+
+    protected:
+      const std::size_t max_;
+      int extra_flags_;
+
+      database_type* db_;
+      slot* slots_;
+
+      details::atomic_count waiters_; // Number of threads waiting.
+
+      details::atomic_count hits_;
+      details::atomic_count misses_;
+
+      std::size_t waits_;             // Protected by mutex_.
+      unsigned long long wait_time_;  // Protected by mutex_.
+
+      details::mutex mutex_;
+      details::condition cond_;
+    };
+  }
+}
+
+#include <odb/sqlite/affine-connection-factory.ixx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_AFFINE_CONNECTION_FACTORY_HXX
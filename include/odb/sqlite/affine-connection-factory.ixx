@@ -0,0 +1,305 @@
+// file      : odb/sqlite/affine-connection-factory.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <functional> // std::less
+
+#include <odb/details/lock.hxx>
+
+#ifdef ODB_CXX11
+#  include <chrono>
+#elif defined(ODB_THREADS_POSIX)
+#  include <sys/time.h> // gettimeofday
+#endif
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // affine_connection_pool_factory
+    //
+
+    template <typename S, typename K>
+    ODB_TLS_POINTER (S) affine_connection_pool_factory::thread_hint<S, K>::
+    value;
+
+    inline affine_connection_pool_factory::
+    affine_connection_pool_factory (std::size_t max_connections)
+        : max_ (max_connections),
+          extra_flags_ (0),
+          db_ (0),
+          slots_ (new slot[max_connections]),
+          waiters_ (0),
+          hits_ (0),
+          misses_ (0),
+          waits_ (0),
+          wait_time_ (0),
+          cond_ (mutex_)
+    {
+      assert (max_connections != 0);
+
+      for (std::size_t i (0); i != max_; ++i)
+      {
+        slots_[i].state = slot::empty;
+        slots_[i].connection = 0;
+      }
+    }
+
+    inline affine_connection_pool_factory::
+    ~affine_connection_pool_factory ()
+    {
+      // Wait for all the connections currently in use to return to the
+      // pool.
+      //
+      {
+        details::lock l (mutex_);
+
+        for (std::size_t i (0); i != max_;)
+        {
+          if (details::atomic_load (slots_[i].state) != slot::busy)
+          {
+            ++i;
+            continue;
+          }
+
+          details::atomic_add (waiters_, 1);
+          cond_.wait ();
+          details::atomic_sub (waiters_, 1);
+        }
+      }
+
+      // The reference count of an idle connection is 0 so we delete it
+      // directly.
+      //
+      for (std::size_t i (0); i != max_; ++i)
+        delete slots_[i].connection;
+
+      delete[] slots_;
+    }
+
+    inline void affine_connection_pool_factory::
+    database (database_type& db)
+    {
+      bool first (db_ == 0);
+      db_ = &db;
+
+      if (!first)
+        return;
+
+      // Unless explicitly disabled, enable shared cache.
+      //
+      if ((db_->flags () & SQLITE_OPEN_PRIVATECACHE) == 0)
+        extra_flags_ |= SQLITE_OPEN_SHAREDCACHE;
+    }
+
+    inline connection_ptr affine_connection_pool_factory::
+    connect ()
+    {
+      // First try to get back the connection this thread used last.
+      //
+      slot* h (hint ());
+
+      if (h != 0 && owns (h) && details::atomic_cas (h->state,
+                                                     slot::idle,
+                                                     slot::busy))
+        return activate (*h, true);
+
+      while (true)
+      {
+        if (slot* s = acquire ())
+          return activate (*s, false);
+
+        // All the connections are in use. Register as a waiter and retry
+        // before going to sleep: a connection released after our attempt
+        // above but before the waiter registration would otherwise go
+        // unnoticed.
+        //
+        details::lock l (mutex_);
+        details::atomic_add (waiters_, 1);
+
+        slot* s (acquire ());
+
+        if (s == 0)
+        {
+          unsigned long long start (now ());
+          cond_.wait ();
+          waits_++;
+          wait_time_ += now () - start;
+        }
+
+        details::atomic_sub (waiters_, 1);
+
+        if (s != 0)
+        {
+          l.unlock ();
+          return activate (*s, false);
+        }
+      }
+    }
+
+    inline affine_connection_pool_factory::statistics_type
+    affine_connection_pool_factory::
+    statistics ()
+    {
+      statistics_type r;
+      r.hits = details::atomic_load (hits_);
+      r.misses = details::atomic_load (misses_);
+
+      details::lock l (mutex_);
+      r.waits = waits_;
+      r.wait_time = wait_time_;
+      return r;
+    }
+
+    inline affine_connection_pool_factory::pooled_connection_ptr
+    affine_connection_pool_factory::
+    create ()
+    {
+      return pooled_connection_ptr (
+        new (details::shared) pooled_connection (*db_, extra_flags_));
+    }
+
+    inline affine_connection_pool_factory::slot*
+    affine_connection_pool_factory::
+    acquire ()
+    {
+      // Prefer existing idle connections to creating new ones.
+      //
+      for (std::size_t i (0); i != max_; ++i)
+      {
+        if (details::atomic_cas (slots_[i].state, slot::idle, slot::busy))
+          return slots_ + i;
+      }
+
+      for (std::size_t i (0); i != max_; ++i)
+      {
+        if (details::atomic_cas (slots_[i].state, slot::empty, slot::busy))
+          return slots_ + i;
+      }
+
+      return 0;
+    }
+
+    inline connection_ptr affine_connection_pool_factory::
+    activate (slot& s, bool hit)
+    {
+      hint (&s);
+      details::atomic_add (hit ? hits_ : misses_, 1);
+
+      if (s.connection != 0)
+        return connection_ptr (details::inc_ref (s.connection));
+
+      pooled_connection_ptr c;
+
+      try
+      {
+        c = create ();
+      }
+      catch (...)
+      {
+        // Give the slot back and let a waiter, if any, retry.
+        //
+        details::atomic_cas (s.state, slot::busy, slot::empty);
+
+        if (details::atomic_load (waiters_) != 0)
+        {
+          details::lock l (mutex_);
+          cond_.signal ();
+        }
+
+        throw;
+      }
+
+      c->pool_ = this;
+      c->slot_ = &s;
+      s.connection = c.get ();
+
+      return c;
+    }
+
+    inline affine_connection_pool_factory::slot*
+    affine_connection_pool_factory::
+    hint () const
+    {
+      return details::tls_get (thread_hint<slot>::value);
+    }
+
+    inline void affine_connection_pool_factory::
+    hint (slot* s)
+    {
+      details::tls_set (thread_hint<slot>::value, s);
+    }
+
+    inline bool affine_connection_pool_factory::
+    owns (const slot* s) const
+    {
+      std::less<const slot*> lt;
+      return !lt (s, slots_) && lt (s, slots_ + max_);
+    }
+
+    inline bool affine_connection_pool_factory::
+    release (pooled_connection* c)
+    {
+      details::atomic_cas (c->slot_->state, slot::busy, slot::idle);
+
+      if (details::atomic_load (waiters_) != 0)
+      {
+        details::lock l (mutex_);
+        cond_.signal ();
+      }
+
+      // Keep the connection; it is owned by its slot.
+      //
+      return false;
+    }
+
+    inline unsigned long long affine_connection_pool_factory::
+    now ()
+    {
+#ifdef ODB_CXX11
+      using namespace std::chrono;
+
+      return static_cast<unsigned long long> (
+        duration_cast<microseconds> (
+          steady_clock::now ().time_since_epoch ()).count ());
+#elif defined(ODB_THREADS_POSIX)
+      timeval tv;
+      gettimeofday (&tv, 0);
+      return static_cast<unsigned long long> (tv.tv_sec) * 1000000 +
+        static_cast<unsigned long long> (tv.tv_usec);
+#else
+      return 0;
+#endif
+    }
+
+    //
+    // affine_connection_pool_factory::pooled_connection
+    //
+
+    inline affine_connection_pool_factory::pooled_connection::
+    pooled_connection (database_type& db, int extra_flags)
+        : connection (db, extra_flags), pool_ (0), slot_ (0)
+    {
+      callback_.arg = this;
+      callback_.zero_counter = &zero_counter;
+      shared_base::callback_ = &callback_;
+    }
+
+    inline affine_connection_pool_factory::pooled_connection::
+    pooled_connection (database_type& db, sqlite3* handle)
+        : connection (db, handle), pool_ (0), slot_ (0)
+    {
+      callback_.arg = this;
+      callback_.zero_counter = &zero_counter;
+      shared_base::callback_ = &callback_;
+    }
+
+    inline bool affine_connection_pool_factory::pooled_connection::
+    zero_counter (void* arg)
+    {
+      pooled_connection* c (static_cast<pooled_connection*> (arg));
+      return c->pool_ != 0 ? c->pool_->release (c) : true;
+    }
+  }
+}
@@ -0,0 +1,220 @@
+// file      : odb/sqlite/blob-stream.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_BLOB_STREAM_HXX
+#define ODB_SQLITE_BLOB_STREAM_HXX
+
+#include <odb/pre.hxx>
+
+#include <sqlite3.h>
+
+#include <string>
+#include <iosfwd>  // std::istream, std::ostream
+#include <cstddef> // std::size_t
+
+#include <odb/traits.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/connection.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Incremental BLOB I/O using the sqlite3_blob_*() functions. Only the
+    // chunk being read or written is held in memory which makes it
+    // possible to handle very large values with bounded memory.
+    //
+    // The blob is identified by its database (schema), table, column, and
+    // rowid and its size
+    // cannot be changed via the stream. To write a new value, first
+    // reserve the space with reserve() (which stores zeroblob(size)) and
+    // then open the stream for writing.
+    //
+    // Note that a BLOB column mapped to an object member is loaded and
+    // stored in its entirety as part of the object. To benefit from
+    // streaming, the column should not be mapped to a persistent member
+    // (for example, it can be added to the table by the application) and
+    // instead accessed with this stream, normally via object_blob_stream
+    // below which ties it to the object's row.
+    //
+    class blob_stream
+    {
+    public:
+      // Open the blob in the specified column of the row with the given
+      // rowid. The schema is the name of the database as given to ATTACH
+      // or "main" for the main database. The schema, table, and column
+      // names should be unquoted.
+      //
+      blob_stream (connection&,
+                   const std::string& table,
+                   const std::string& column,
+                   long long rowid,
+                   bool write = false);
+
+      blob_stream (connection&,
+                   const std::string& schema,
+                   const std::string& table,
+                   const std::string& column,
+                   long long rowid,
+                   bool write = false);
+
+      ~blob_stream ();
+
+      // Store zeroblob(size) in the specified column of the row with the
+      // given rowid. Any existing value is discarded.
+      //
+      static void
+      reserve (connection&,
+               const std::string& table,
+               const std::string& column,
+               long long rowid,
+               std::size_t size);
+
+      static void
+      reserve (connection&,
+               const std::string& schema,
+               const std::string& table,
+               const std::string& column,
+               long long rowid,
+               std::size_t size);
+
+    public:
+      std::size_t
+      size () const
+      {
+        return size_;
+      }
+
+      // Current position for the sequential read() and write() functions.
+      //
+      std::size_t
+      position () const
+      {
+        return position_;
+      }
+
+      void
+      seek (std::size_t position)
+      {
+        position_ = position;
+      }
+
+      // Read up to n bytes starting from the current position. Return the
+      // number of bytes read which is less than n only at the end of the
+      // blob.
+      //
+      std::size_t
+      read (void* buffer, std::size_t n);
+
+      // Write n bytes starting from the current position. Writing past the
+      // end of the blob is an error.
+      //
+      void
+      write (const void* buffer, std::size_t n);
+
+      // Random access versions. The position is not changed. Accessing
+      // bytes past the end of the blob is an error and results in
+      // database_exception being thrown without any data transferred.
+      //
+      void
+      read (void* buffer, std::size_t n, std::size_t offset);
+
+      void
+      write (const void* buffer, std::size_t n, std::size_t offset);
+
+      // Copy the rest of the blob to the output stream or fill it from the
+      // input stream in chunks of the specified size. For the input stream
+      // version, return the number of bytes written.
+      //
+      void
+      read (std::ostream&, std::size_t chunk = 65536);
+
+      std::size_t
+      write (std::istream&, std::size_t chunk = 65536);
+
+      // Point the stream to the same column in another row. The position
+      // is reset to 0.
+      //
+      void
+      reopen (long long rowid);
+
+      void
+      close ();
+
+    protected:
+      // Quote the identifier, doubling the embedded quotes, as is done in
+      // the generated statements, and reverse that.
+      //
+      static std::string
+      quote (const std::string&);
+
+      static std::string
+      unquote (const std::string&);
+
+    private:
+      blob_stream (const blob_stream&);
+      blob_stream& operator= (const blob_stream&);
+
+      void
+      open (const char* schema,
+            const std::string& table,
+            const std::string& column,
+            long long rowid,
+            bool write);
+
+      // Throw if the range is not within the blob.
+      //
+      void
+      check (std::size_t n, std::size_t offset) const;
+
+    private:
+      connection& conn_;
+      sqlite3_blob* handle_;
+      std::size_t size_;
+      std::size_t position_;
+    };
+
+    // Blob stream for a column in the row of a persistent object. The
+    // object id must be an integer that is also the row's rowid (that
+    // is, the id column is INTEGER PRIMARY KEY, which is the default for
+    // integer ids).
+    //
+    template <typename T>
+    class object_blob_stream: public blob_stream
+    {
+    public:
+      typedef typename object_traits<T>::id_type id_type;
+
+      object_blob_stream (connection&,
+                          const std::string& column,
+                          const id_type& id,
+                          bool write = false);
+
+      static void
+      reserve (connection&,
+               const std::string& column,
+               const id_type& id,
+               std::size_t size);
+
+      // Return the object's unquoted schema and table names. The table
+      // name in the generated code may be qualified with the schema (see
+      // the schema pragma) and the schema is "main" if it is not.
+      //
+      static std::string
+      schema ();
+
+      static std::string
+      table ();
+    };
+  }
+}
+
+#include <odb/sqlite/blob-stream.ixx>
+#include <odb/sqlite/blob-stream.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_BLOB_STREAM_HXX
@@ -0,0 +1,258 @@
+// file      : odb/sqlite/blob-stream.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <sstream>
+#include <istream>
+#include <ostream>
+
+#include <odb/details/buffer.hxx>
+
+#include <odb/sqlite/error.hxx>
+#include <odb/sqlite/exceptions.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    inline blob_stream::
+    blob_stream (connection& c,
+                 const std::string& table,
+                 const std::string& column,
+                 long long rowid,
+                 bool write)
+        : conn_ (c), handle_ (0), size_ (0), position_ (0)
+    {
+      open ("main", table, column, rowid, write);
+    }
+
+    inline blob_stream::
+    blob_stream (connection& c,
+                 const std::string& schema,
+                 const std::string& table,
+                 const std::string& column,
+                 long long rowid,
+                 bool write)
+        : conn_ (c), handle_ (0), size_ (0), position_ (0)
+    {
+      open (schema.c_str (), table, column, rowid, write);
+    }
+
+    inline void blob_stream::
+    open (const char* schema,
+          const std::string& table,
+          const std::string& column,
+          long long rowid,
+          bool write)
+    {
+      int e (sqlite3_blob_open (conn_.handle (),
+                                schema,
+                                table.c_str (),
+                                column.c_str (),
+                                static_cast<sqlite3_int64> (rowid),
+                                write ? 1 : 0,
+                                &handle_));
+      if (e != SQLITE_OK)
+      {
+        // Even on failure the handle may need to be closed.
+        //
+        if (handle_ != 0)
+        {
+          sqlite3_blob_close (handle_);
+          handle_ = 0;
+        }
+
+        translate_error (e, conn_);
+      }
+
+      size_ = static_cast<std::size_t> (sqlite3_blob_bytes (handle_));
+    }
+
+    inline blob_stream::
+    ~blob_stream ()
+    {
+      if (handle_ != 0)
+        sqlite3_blob_close (handle_);
+    }
+
+    inline void blob_stream::
+    reserve (connection& c,
+             const std::string& table,
+             const std::string& column,
+             long long rowid,
+             std::size_t size)
+    {
+      reserve (c, "main", table, column, rowid, size);
+    }
+
+    inline void blob_stream::
+    reserve (connection& c,
+             const std::string& schema,
+             const std::string& table,
+             const std::string& column,
+             long long rowid,
+             std::size_t size)
+    {
+      std::ostringstream os;
+      os << "UPDATE " << quote (schema) << '.' << quote (table) << " SET "
+         << quote (column) << "=zeroblob(" << size << ") WHERE rowid="
+         << rowid;
+
+      std::string s (os.str ());
+      c.execute (s.c_str (), s.size ());
+    }
+
+    inline std::size_t blob_stream::
+    read (void* buffer, std::size_t n)
+    {
+      if (position_ >= size_)
+        return 0;
+
+      if (n > size_ - position_)
+        n = size_ - position_;
+
+      read (buffer, n, position_);
+      position_ += n;
+      return n;
+    }
+
+    inline void blob_stream::
+    write (const void* buffer, std::size_t n)
+    {
+      write (buffer, n, position_);
+      position_ += n;
+    }
+
+    inline void blob_stream::
+    read (void* buffer, std::size_t n, std::size_t offset)
+    {
+      check (n, offset);
+
+      int e (sqlite3_blob_read (handle_,
+                                buffer,
+                                static_cast<int> (n),
+                                static_cast<int> (offset)));
+      if (e != SQLITE_OK)
+        translate_error (e, conn_);
+    }
+
+    inline void blob_stream::
+    write (const void* buffer, std::size_t n, std::size_t offset)
+    {
+      check (n, offset);
+
+      int e (sqlite3_blob_write (handle_,
+                                 buffer,
+                                 static_cast<int> (n),
+                                 static_cast<int> (offset)));
+      if (e != SQLITE_OK)
+        translate_error (e, conn_);
+    }
+
+    inline void blob_stream::
+    check (std::size_t n, std::size_t offset) const
+    {
+      // The blob size is an int so this also guarantees that n and offset
+      // fit into the int arguments of sqlite3_blob_read/write().
+      //
+      if (n > size_ || offset > size_ - n)
+        throw database_exception (
+          SQLITE_ERROR, SQLITE_ERROR, "blob access out of range");
+    }
+
+    inline void blob_stream::
+    read (std::ostream& os, std::size_t chunk)
+    {
+      details::buffer b (chunk);
+
+      for (std::size_t n; (n = read (b.data (), chunk)) != 0;)
+        os.write (b.data (), static_cast<std::streamsize> (n));
+    }
+
+    inline std::size_t blob_stream::
+    write (std::istream& is, std::size_t chunk)
+    {
+      details::buffer b (chunk);
+      std::size_t r (0);
+
+      while (is && position_ < size_)
+      {
+        std::size_t n (size_ - position_);
+        if (n > chunk)
+          n = chunk;
+
+        is.read (b.data (), static_cast<std::streamsize> (n));
+        n = static_cast<std::size_t> (is.gcount ());
+
+        if (n == 0)
+          break;
+
+        write (b.data (), n);
+        r += n;
+      }
+
+      return r;
+    }
+
+    inline std::string blob_stream::
+    quote (const std::string& n)
+    {
+      std::string r ("\"");
+
+      for (std::string::const_iterator i (n.begin ()); i != n.end (); ++i)
+      {
+        if (*i == '"')
+          r += '"';
+
+        r += *i;
+      }
+
+      r += '"';
+      return r;
+    }
+
+    inline std::string blob_stream::
+    unquote (const std::string& n)
+    {
+      if (n.size () < 2 || n[0] != '"' || n[n.size () - 1] != '"')
+        return n;
+
+      std::string r;
+
+      for (std::string::size_type i (1), e (n.size () - 1); i != e; ++i)
+      {
+        r += n[i];
+
+        if (n[i] == '"' && i + 1 != e && n[i + 1] == '"')
+          ++i;
+      }
+
+      return r;
+    }
+
+    inline void blob_stream::
+    reopen (long long rowid)
+    {
+      int e (sqlite3_blob_reopen (handle_,
+                                  static_cast<sqlite3_int64> (rowid)));
+      if (e != SQLITE_OK)
+        translate_error (e, conn_);
+
+      size_ = static_cast<std::size_t> (sqlite3_blob_bytes (handle_));
+      position_ = 0;
+    }
+
+    inline void blob_stream::
+    close ()
+    {
+      if (handle_ != 0)
+      {
+        int e (sqlite3_blob_close (handle_));
+        handle_ = 0;
+
+        if (e != SQLITE_OK)
+          translate_error (e, conn_);
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+// file      : odb/sqlite/blob-stream.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename T>
+    object_blob_stream<T>::
+    object_blob_stream (connection& c,
+                        const std::string& column,
+                        const id_type& id,
+                        bool write)
+        : blob_stream (c,
+                       schema (),
+                       table (),
+                       column,
+                       static_cast<long long> (id),
+                       write)
+    {
+    }
+
+    template <typename T>
+    void object_blob_stream<T>::
+    reserve (connection& c,
+             const std::string& column,
+             const id_type& id,
+             std::size_t size)
+    {
+      blob_stream::reserve (
+        c, schema (), table (), column, static_cast<long long> (id), size);
+    }
+
+    template <typename T>
+    std::string object_blob_stream<T>::
+    schema ()
+    {
+      // The table name in the generated code is quoted and, if qualified,
+      // has the "schema"."table" form.
+      //
+      std::string r (object_traits_impl<T, id_sqlite>::table_name);
+
+      std::string::size_type p (r.find ("\".\""));
+      if (p == std::string::npos || r.empty () || r[0] != '"')
+        return "main";
+
+      return unquote (std::string (r, 0, p + 1));
+    }
+
+    template <typename T>
+    std::string object_blob_stream<T>::
+    table ()
+    {
+      std::string r (object_traits_impl<T, id_sqlite>::table_name);
+
+      std::string::size_type p (r.find ("\".\""));
+      if (p != std::string::npos)
+        r.erase (0, p + 2);
+
+      return unquote (r);
+    }
+  }
+}
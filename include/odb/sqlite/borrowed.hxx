@@ -0,0 +1,152 @@
+// file      : odb/sqlite/borrowed.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_BORROWED_HXX
+#define ODB_SQLITE_BORROWED_HXX
+
+#include <odb/pre.hxx>
+
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/details/buffer.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/traits.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Borrowed TEXT and BLOB view members. Instead of copying the column
+    // data into the member, these types point directly into the view
+    // statement's image buffer. The data stays valid only until the next
+    // row is loaded (or the result is freed), which makes them suitable
+    // for read-only, row-at-a-time processing such as reporting views.
+    // The database types have to be mapped explicitly, for example:
+    //
+    // #pragma db value(odb::sqlite::borrowed_text) type("TEXT")
+    // #pragma db value(odb::sqlite::borrowed_blob) type("BLOB")
+    //
+    // #pragma db view object(employee)
+    // struct employee_name
+    // {
+    //   odb::sqlite::borrowed_text first;
+    //   odb::sqlite::borrowed_text last;
+    //   odb::sqlite::borrowed_blob photo;
+    // };
+    //
+    // These types cannot be used as object members since objects outlive
+    // the row they were loaded from and are also stored. There is no
+    // conversion to the image so such a use does not compile. In query
+    // conditions, the corresponding owned type (std::string or
+    // std::vector<unsigned char>) is used.
+    //
+    // The data is not NUL-terminated. Use str() to make an owned copy if
+    // the value needs to outlive the current row. A NULL value is
+    // represented by a null data pointer.
+    //
+    template <typename C>
+    struct borrowed_owned_type
+    {
+      typedef std::basic_string<C> type;
+    };
+
+    // There is no std::char_traits<unsigned char> in some standard
+    // libraries.
+    //
+    template <>
+    struct borrowed_owned_type<unsigned char>
+    {
+      typedef std::vector<unsigned char> type;
+    };
+
+    template <typename C>
+    struct borrowed_value
+    {
+      typedef typename borrowed_owned_type<C>::type owned_type;
+
+      borrowed_value (): data (0), size (0) {}
+      borrowed_value (const C* d, std::size_t n): data (d), size (n) {}
+
+      bool
+      null () const
+      {
+        return data == 0;
+      }
+
+      bool
+      empty () const
+      {
+        return size == 0;
+      }
+
+      owned_type
+      str () const
+      {
+        return data != 0 ? owned_type (data, data + size) : owned_type ();
+      }
+
+      const C* data;
+      std::size_t size;
+    };
+
+    typedef borrowed_value<char> borrowed_text;
+    typedef borrowed_value<unsigned char> borrowed_blob;
+
+    // Only set_value() is provided since these are view members (see
+    // above).
+    //
+    template <typename C>
+    struct borrowed_value_traits
+    {
+      typedef borrowed_value<C> value_type;
+      typedef typename value_type::owned_type query_type;
+      typedef details::buffer image_type;
+
+      static void
+      set_value (value_type& v,
+                 const details::buffer& b,
+                 std::size_t n,
+                 bool is_null)
+      {
+        if (!is_null)
+        {
+          v.data = reinterpret_cast<const C*> (b.data ());
+          v.size = n;
+        }
+        else
+        {
+          v.data = 0;
+          v.size = 0;
+        }
+      }
+    };
+
+    template <>
+    struct default_value_traits<borrowed_text, id_text>:
+      borrowed_value_traits<char> {};
+
+    template <>
+    struct default_value_traits<borrowed_blob, id_blob>:
+      borrowed_value_traits<unsigned char> {};
+
+    template <>
+    struct default_type_traits<borrowed_text>
+    {
+      static const database_type_id db_type_id = id_text;
+    };
+
+    template <>
+    struct default_type_traits<borrowed_blob>
+    {
+      static const database_type_id db_type_id = id_blob;
+    };
+  }
+}
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_BORROWED_HXX
@@ -0,0 +1,311 @@
+// file      : odb/sqlite/columnar-result.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_COLUMNAR_RESULT_HXX
+#define ODB_SQLITE_COLUMNAR_RESULT_HXX
+
+#include <odb/pre.hxx>
+
+#include <sqlite3.h>
+
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/forward.hxx> // id_sqlite
+
+#include <odb/details/shared-ptr.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/query.hxx>
+#include <odb/sqlite/binding.hxx>
+#include <odb/sqlite/statement.hxx>
+#include <odb/sqlite/query-builder.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Null bitmap for a column. Bit i is set if the value in row i is
+    // NULL. The bits are packed into 64-bit words, least significant bit
+    // first.
+    //
+    class null_bitmap
+    {
+    public:
+      typedef unsigned long long word_type;
+      static const std::size_t word_bits = 64;
+
+      null_bitmap (): size_ (0) {}
+
+      std::size_t
+      size () const
+      {
+        return size_;
+      }
+
+      bool
+      operator[] (std::size_t i) const
+      {
+        return (words_[i / word_bits] >> (i % word_bits)) & 1;
+      }
+
+      // Return true if there are no NULL values.
+      //
+      bool
+      none () const;
+
+      const std::vector<word_type>&
+      words () const
+      {
+        return words_;
+      }
+
+      void
+      clear ()
+      {
+        words_.clear ();
+        size_ = 0;
+      }
+
+      void
+      reserve (std::size_t n)
+      {
+        words_.reserve ((n + word_bits - 1) / word_bits);
+      }
+
+      void
+      push_back (bool null);
+
+    private:
+      std::vector<word_type> words_;
+      std::size_t size_;
+    };
+
+    // Extraction of a column value into a columnar buffer element. The
+    // value of a NULL column is value-initialized.
+    //
+    template <typename T>
+    struct columnar_value;
+
+    template <typename T>
+    struct columnar_integer_value
+    {
+      static T
+      get (sqlite3_stmt* s, int c)
+      {
+        return static_cast<T> (sqlite3_column_int64 (s, c));
+      }
+    };
+
+    template <typename T>
+    struct columnar_real_value
+    {
+      static T
+      get (sqlite3_stmt* s, int c)
+      {
+        return static_cast<T> (sqlite3_column_double (s, c));
+      }
+    };
+
+    template <>
+    struct columnar_value<bool>
+    {
+      static bool
+      get (sqlite3_stmt* s, int c)
+      {
+        return sqlite3_column_int64 (s, c) != 0;
+      }
+    };
+
+    template <>
+    struct columnar_value<signed char>: columnar_integer_value<signed char> {};
+
+    template <>
+    struct columnar_value<unsigned char>:
+      columnar_integer_value<unsigned char> {};
+
+    template <>
+    struct columnar_value<short>: columnar_integer_value<short> {};
+
+    template <>
+    struct columnar_value<unsigned short>:
+      columnar_integer_value<unsigned short> {};
+
+    template <>
+    struct columnar_value<int>: columnar_integer_value<int> {};
+
+    template <>
+    struct columnar_value<unsigned int>:
+      columnar_integer_value<unsigned int> {};
+
+    template <>
+    struct columnar_value<long>: columnar_integer_value<long> {};
+
+    template <>
+    struct columnar_value<unsigned long>:
+      columnar_integer_value<unsigned long> {};
+
+    template <>
+    struct columnar_value<long long>: columnar_integer_value<long long> {};
+
+    template <>
+    struct columnar_value<unsigned long long>:
+      columnar_integer_value<unsigned long long> {};
+
+    template <>
+    struct columnar_value<float>: columnar_real_value<float> {};
+
+    template <>
+    struct columnar_value<double>: columnar_real_value<double> {};
+
+    template <>
+    struct columnar_value<std::string>
+    {
+      static std::string
+      get (sqlite3_stmt* s, int c)
+      {
+        const char* p (
+          reinterpret_cast<const char*> (sqlite3_column_text (s, c)));
+        return p != 0
+          ? std::string (p, static_cast<std::size_t> (
+                              sqlite3_column_bytes (s, c)))
+          : std::string ();
+      }
+    };
+
+    // Columnar (structure-of-arrays) query result. Instead of loading one
+    // object or view instance at a time through the image binding, each
+    // call to fetch() reads up to N rows directly from the statement into
+    // caller-provided vectors, one per column, with NULLs reported in
+    // optional per-column bitmaps. For example:
+    //
+    // columnar_result r (c, query ("SELECT id, amount FROM sale"));
+    //
+    // std::vector<long long> id;
+    // std::vector<double> amount;
+    // null_bitmap amount_null;
+    //
+    // r.bind (0, id);
+    // r.bind (1, amount, &amount_null);
+    //
+    // while (std::size_t n = r.fetch (4096))
+    // {
+    //   ...
+    // }
+    //
+    // The query should be a complete SELECT statement. To execute the
+    // query of a view, use view_columnar_result below. The result should
+    // be used within a transaction on the specified connection.
+    //
+    class columnar_result
+    {
+    public:
+      columnar_result (connection&, const query_base&);
+
+      // The builder should remain valid until the result is destroyed.
+      //
+      columnar_result (connection&, const query_builder&);
+
+      ~columnar_result ();
+
+      // Bind the vector (and, optionally, the null bitmap) to the column
+      // with the specified zero-based index in the select list. Columns
+      // that are not bound are skipped.
+      //
+      template <typename T>
+      void
+      bind (std::size_t column,
+            std::vector<T>& values,
+            null_bitmap* nulls = 0);
+
+      // Replace the contents of the bound vectors and bitmaps with up to
+      // n next rows. Return the number of rows fetched which is 0 once
+      // the result is exhausted.
+      //
+      std::size_t
+      fetch (std::size_t n);
+
+      bool
+      end () const
+      {
+        return end_;
+      }
+
+    private:
+      columnar_result (const columnar_result&);
+      columnar_result& operator= (const columnar_result&);
+
+      void
+      execute (connection&, const char* text, binding& params);
+
+    private:
+      struct column_base
+      {
+        column_base (int c, null_bitmap* n): column (c), nulls (n) {}
+
+        virtual
+        ~column_base () {}
+
+        virtual void
+        clear (std::size_t reserve) = 0;
+
+        virtual void
+        append (sqlite3_stmt*) = 0;
+
+        int column;
+        null_bitmap* nulls;
+      };
+
+      template <typename T>
+      struct column_impl: column_base
+      {
+        column_impl (int c, std::vector<T>& v, null_bitmap* n)
+            : column_base (c, n), values (v)
+        {
+        }
+
+        virtual void
+        clear (std::size_t reserve);
+
+        virtual void
+        append (sqlite3_stmt*);
+
+        std::vector<T>& values;
+      };
+
+      typedef std::vector<column_base*> columns;
+
+      // We need to hold on to the query parameters because SQLite uses
+      // the parameter buffers to find each next row.
+      //
+      details::shared_ptr<query_params> params_;
+      details::shared_ptr<select_statement> statement_;
+      binding result_;
+
+      columns columns_;
+      bool end_;
+    };
+
+    // Columnar result for the query of a view. The view's select list
+    // determines the column indexes.
+    //
+    template <typename V>
+    class view_columnar_result: public columnar_result
+    {
+    public:
+      typedef view_traits_impl<V, id_sqlite> view_traits;
+
+      view_columnar_result (connection&, const query_base& = query_base ());
+    };
+  }
+}
+
+#include <odb/sqlite/columnar-result.ixx>
+#include <odb/sqlite/columnar-result.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_COLUMNAR_RESULT_HXX
@@ -0,0 +1,110 @@
+// file      : odb/sqlite/columnar-result.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // null_bitmap
+    //
+
+    inline bool null_bitmap::
+    none () const
+    {
+      for (std::vector<word_type>::const_iterator i (words_.begin ());
+           i != words_.end (); ++i)
+      {
+        if (*i != 0)
+          return false;
+      }
+
+      return true;
+    }
+
+    inline void null_bitmap::
+    push_back (bool null)
+    {
+      std::size_t b (size_++ % word_bits);
+
+      if (b == 0)
+        words_.push_back (0);
+
+      if (null)
+        words_.back () |= word_type (1) << b;
+    }
+
+    //
+    // columnar_result
+    //
+
+    inline columnar_result::
+    columnar_result (connection& c, const query_base& q)
+        : params_ (q.parameters ()), end_ (false)
+    {
+      q.init_parameters ();
+      execute (c, q.clause ().c_str (), q.parameters_binding ());
+    }
+
+    inline columnar_result::
+    columnar_result (connection& c, const query_builder& q)
+        : end_ (false)
+    {
+      q.init_parameters ();
+      execute (c, q.clause (), q.parameters_binding ());
+    }
+
+    inline void columnar_result::
+    execute (connection& c, const char* text, binding& params)
+    {
+      // The result binding is empty since the columns are extracted
+      // directly from the statement.
+      //
+      statement_.reset (
+        new (details::shared) select_statement (c, text, params, result_));
+
+      statement_->execute ();
+    }
+
+    inline columnar_result::
+    ~columnar_result ()
+    {
+      if (!end_)
+        statement_->free_result ();
+
+      for (columns::iterator i (columns_.begin ()); i != columns_.end (); ++i)
+        delete *i;
+    }
+
+    inline std::size_t columnar_result::
+    fetch (std::size_t n)
+    {
+      for (columns::iterator i (columns_.begin ()); i != columns_.end (); ++i)
+        (*i)->clear (end_ ? 0 : n);
+
+      std::size_t r (0);
+
+      if (end_)
+        return r;
+
+      sqlite3_stmt* s (statement_->handle ());
+
+      for (; r != n; ++r)
+      {
+        if (!statement_->next ())
+        {
+          statement_->free_result ();
+          end_ = true;
+          break;
+        }
+
+        for (columns::iterator i (columns_.begin ());
+             i != columns_.end (); ++i)
+          (*i)->append (s);
+      }
+
+      return r;
+    }
+  }
+}
@@ -0,0 +1,76 @@
+// file      : odb/sqlite/columnar-result.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // columnar_result
+    //
+
+    template <typename T>
+    void columnar_result::
+    bind (std::size_t column, std::vector<T>& values, null_bitmap* nulls)
+    {
+      column_base* c (
+        new column_impl<T> (static_cast<int> (column), values, nulls));
+
+      try
+      {
+        columns_.push_back (c);
+      }
+      catch (...)
+      {
+        delete c;
+        throw;
+      }
+    }
+
+    template <typename T>
+    void columnar_result::column_impl<T>::
+    clear (std::size_t n)
+    {
+      values.clear ();
+      values.reserve (n);
+
+      if (nulls != 0)
+      {
+        nulls->clear ();
+        nulls->reserve (n);
+      }
+    }
+
+    template <typename T>
+    void columnar_result::column_impl<T>::
+    append (sqlite3_stmt* s)
+    {
+      if (sqlite3_column_type (s, column) != SQLITE_NULL)
+      {
+        values.push_back (columnar_value<T>::get (s, column));
+
+        if (nulls != 0)
+          nulls->push_back (false);
+      }
+      else
+      {
+        values.push_back (T ());
+
+        if (nulls != 0)
+          nulls->push_back (true);
+      }
+    }
+
+    //
+    // view_columnar_result
+    //
+
+    template <typename V>
+    view_columnar_result<V>::
+    view_columnar_result (connection& c, const query_base& q)
+        : columnar_result (c, view_traits::query_statement (q))
+    {
+    }
+  }
+}
@@ -7,10 +7,15 @@
 
 #include <odb/pre.hxx>
 
+#include <string>
+#include <vector>
 #include <cstddef> // std::size_t
 
 #include <odb/forward.hxx>
 #include <odb/traits.hxx>
+#include <odb/container-traits.hxx>
+
+#include <odb/details/unique-ptr.hxx>
 
 #include <odb/sqlite/version.hxx>
 #include <odb/sqlite/binding.hxx>
@@ -144,10 +149,70 @@ namespace odb
         return *delete_;
       }
 
+      // Batched insert of ordered container elements. Used as the insert_n
+      // function by ordered containers.
+      //
+      template <typename I, typename V>
+      static void
+      insert_n (I index, const V* const* values, std::size_t n, void*);
+
     private:
       container_statements (const container_statements&);
       container_statements& operator= (const container_statements&);
 
+      template <typename I, typename V>
+      void
+      init_functions (ordered_functions<I, V>& f)
+      {
+        f.insert_n_ = &insert_n<I, V>;
+      }
+
+      template <typename I, typename V>
+      void
+      init_functions (smart_ordered_functions<I, V>& f)
+      {
+        f.insert_n_ = &insert_n<I, V>;
+      }
+
+      template <typename F>
+      void
+      init_functions (F&)
+      {
+      }
+
+      // Return the maximum number of rows that can be inserted with a
+      // single statement execution or 1 if batching is not possible.
+      // The result is a power of two.
+      //
+      std::size_t
+      batch_rows ();
+
+      // Insert a batch of rows. The number of rows should be a power of
+      // two not greater than batch_rows(). The statement for each size
+      // is prepared on first use.
+      //
+      template <typename I, typename V>
+      void
+      insert_batch (I index, const V* const* values, std::size_t rows);
+
+      // The multi-row insert statement with a separate data image for
+      // each row. The images stay bound to the statement between the
+      // executions unless they change.
+      //
+      struct batch_type
+      {
+        batch_type (std::size_t rows, std::size_t columns);
+        ~batch_type ();
+
+        std::size_t rows;
+        data_image_type* images;
+        std::vector<std::size_t> image_versions;
+        std::size_t id_binding_version;
+        std::vector<bind> binds;
+        binding param;
+        details::shared_ptr<insert_statement_type> statement;
+      };
+
     protected:
       connection_type& conn_;
       binding& id_binding_;
@@ -170,6 +235,14 @@ namespace odb
       details::shared_ptr<insert_statement_type> insert_;
       details::shared_ptr<select_statement_type> select_;
       details::shared_ptr<delete_statement_type> delete_;
+
+      // Batch statements indexed by the binary logarithm of their row
+      // count.
+      //
+      static const std::size_t batch_sizes = 16;
+
+      std::size_t batch_rows_; // 0 if not yet determined.
+      details::unique_ptr<batch_type> batches_[batch_sizes];
     };
 
     template <typename T>
@@ -2,9 +2,15 @@
 // copyright : Copyright (c) 2005-2013 Code Synthesis Tools CC
 // license   : GNU GPL v2; see accompanying LICENSE file
 
+#include <sqlite3.h>
+
 #include <cstddef> // std::size_t
 #include <cstring> // std::memset
 
+#include <odb/exceptions.hxx> // object_already_persistent
+
+#include <odb/sqlite/connection.hxx>
+
 namespace odb
 {
   namespace sqlite
@@ -18,17 +24,210 @@ namespace odb
           id_binding_ (id),
           functions_ (this),
           insert_image_binding_ (0, 0), // Initialized by impl.
-          select_image_binding_ (0, 0)  // Initialized by impl.
+          select_image_binding_ (0, 0), // Initialized by impl.
+          batch_rows_ (0)
     {
       functions_.insert_ = &traits::insert;
       functions_.select_ = &traits::select;
       functions_.delete__ = &traits::delete_;
+      init_functions (functions_);
 
       data_image_.version = 0;
       data_image_version_ = 0;
       data_id_binding_version_ = 0;
     }
 
+    template <typename T>
+    template <typename I, typename V>
+    void container_statements<T>::
+    insert_n (I index, const V* const* values, std::size_t n, void* d)
+    {
+      container_statements& sts (*static_cast<container_statements*> (d));
+
+      std::size_t i (0);
+      std::size_t max (n >= 2 ? sts.batch_rows () : 1);
+
+      // Use the largest batch that fits into what is left. Since the
+      // sizes are powers of two, at most one row remains at the end.
+      //
+      while (max > 1 && n - i >= 2)
+      {
+        std::size_t rows (max);
+
+        while (rows > n - i)
+          rows >>= 1;
+
+        sts.insert_batch (index + static_cast<I> (i), values + i, rows);
+        i += rows;
+      }
+
+      for (; i != n; ++i)
+        traits::insert (index + static_cast<I> (i), *values[i], d);
+    }
+
+    template <typename T>
+    std::size_t container_statements<T>::
+    batch_rows ()
+    {
+      if (batch_rows_ != 0)
+        return batch_rows_;
+
+      batch_rows_ = 1;
+
+      // Multi-row VALUES clause is supported since SQLite 3.7.11.
+      //
+      if (sqlite3_libversion_number () < 3007011)
+        return 1;
+
+      // The statement is built by repeating the values tuple at the end
+      // of the insert statement.
+      //
+      std::string text (insert_text_);
+      std::string::size_type p (text.rfind ("VALUES"));
+
+      if (p == std::string::npos ||
+          text.find ('(', p) == std::string::npos ||
+          text[text.size () - 1] != ')')
+        return 1;
+
+      // Stay within the limit on the number of parameters. Before 3.8.8
+      // a multi-row VALUES clause is implemented as a compound SELECT and
+      // is also subject to the limit on the number of its terms.
+      //
+      std::size_t columns (insert_image_binding_.count);
+      sqlite3* h (conn_.handle ());
+
+      std::size_t rows (
+        static_cast<std::size_t> (
+          sqlite3_limit (h, SQLITE_LIMIT_VARIABLE_NUMBER, -1)));
+
+      if (columns != 0)
+        rows /= columns;
+
+      if (sqlite3_libversion_number () < 3008008)
+      {
+        std::size_t compound (
+          static_cast<std::size_t> (
+            sqlite3_limit (h, SQLITE_LIMIT_COMPOUND_SELECT, -1)));
+
+        if (compound != 0 && rows > compound)
+          rows = compound;
+      }
+
+      std::size_t r (1);
+
+      for (std::size_t k (1); k != batch_sizes && 2 * r <= rows; ++k)
+        r *= 2;
+
+      batch_rows_ = r;
+      return r;
+    }
+
+    template <typename T>
+    template <typename I, typename V>
+    void container_statements<T>::
+    insert_batch (I index, const V* const* values, std::size_t rows)
+    {
+      std::size_t k (0);
+
+      while ((static_cast<std::size_t> (1) << k) != rows)
+        k++;
+
+      std::size_t columns (insert_image_binding_.count);
+
+      if (!batches_[k])
+      {
+        std::string text (insert_text_);
+        std::string tuple (text, text.find ('(', text.rfind ("VALUES")));
+
+        for (std::size_t i (1); i != rows; ++i)
+        {
+          text += ", ";
+          text += tuple;
+        }
+
+        details::unique_ptr<batch_type> b (new batch_type (rows, columns));
+
+        b->statement.reset (
+          new (details::shared) insert_statement_type (
+            conn_, text, b->param));
+
+        batches_[k].reset (b.release ());
+      }
+
+      batch_type& b (*batches_[k]);
+
+      bool rebind (b.id_binding_version != id_binding_.version ||
+                   b.param.version == 0);
+
+      for (std::size_t r (0); r != b.rows; ++r)
+      {
+        I i (index + static_cast<I> (r));
+        data_image_type& im (b.images[r]);
+
+        traits::init (im, &i, *values[r]);
+
+        if (b.image_versions[r] != im.version)
+          rebind = true;
+      }
+
+      if (rebind)
+      {
+        for (std::size_t r (0); r != b.rows; ++r)
+        {
+          data_image_type& im (b.images[r]);
+
+          traits::bind (&b.binds[r * columns],
+                        id_binding_.bind,
+                        id_binding_.count,
+                        im);
+
+          b.image_versions[r] = im.version;
+        }
+
+        b.id_binding_version = id_binding_.version;
+        b.param.version++;
+      }
+
+      if (!b.statement->execute ())
+        throw object_already_persistent ();
+    }
+
+    template <typename T>
+    container_statements<T>::batch_type::
+    batch_type (std::size_t r, std::size_t columns)
+        : rows (r),
+          images (new data_image_type[r]),
+          image_versions (r, 0),
+          id_binding_version (0)
+    {
+      for (std::size_t i (0); i != r; ++i)
+        images[i].version = 0;
+
+      try
+      {
+        bind b;
+        std::memset (&b, 0, sizeof (b));
+        binds.resize (r * columns, b);
+      }
+      catch (...)
+      {
+        delete[] images;
+        throw;
+      }
+
+      param.bind = &binds[0];
+      param.count = binds.size ();
+    }
+
+    template <typename T>
+    container_statements<T>::batch_type::
+    ~batch_type ()
+    {
+      statement.reset ();
+      delete[] images;
+    }
+
     // smart_container_statements
     //
     template <typename T>
@@ -0,0 +1,194 @@
+// file      : odb/sqlite/contention-policy.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_CONTENTION_POLICY_HXX
+#define ODB_SQLITE_CONTENTION_POLICY_HXX
+
+#include <odb/pre.hxx>
+
+#include <sqlite3.h>
+
+#include <map>
+#include <cstddef> // std::size_t
+
+#include <odb/details/mutex.hxx>
+#include <odb/details/atomic.hxx>
+#include <odb/details/unique-ptr.hxx>
+#include <odb/details/transfer-ptr.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/connection-factory.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Handling of SQLITE_BUSY with exponential backoff. When attached to
+    // a connection, the policy is installed as its busy handler so that
+    // a statement (including BEGIN and COMMIT) that finds the database
+    // locked by another connection sleeps and retries transparently
+    // instead of failing with odb::timeout. The delay starts at
+    // initial_delay and doubles with each attempt up to max_delay, with
+    // random jitter so that competing connections do not retry in lock
+    // step. Once the deadline has passed since the statement first got
+    // blocked, it fails as before.
+    //
+    // SQLite does not call the busy handler in situations where waiting
+    // cannot help, for example, when a deferred transaction holding a
+    // shared lock tries to upgrade it while another connection is
+    // writing. In this case the whole transaction has to be rolled back
+    // and re-executed, which retry() below does within the same deadline.
+    //
+    // All the times are in milliseconds except for the blocked time
+    // accounting which is in microseconds. The per-connection state is
+    // owned by the connection's handle and is released when the handle is
+    // closed. If the policy is destroyed first, then it is uninstalled
+    // from the handles that are still open, which then fail with
+    // odb::timeout on SQLITE_BUSY as before.
+    //
+    class contention_policy
+    {
+    public:
+      contention_policy (unsigned int initial_delay = 1,
+                         unsigned int max_delay = 100,
+                         unsigned int deadline = 5000);
+
+      ~contention_policy ();
+
+      // Install the policy as the connection's busy handler. Attaching
+      // a connection again is cheap and does nothing.
+      //
+      void
+      attach (connection&);
+
+      // Execute a unit of work (a function object called without any
+      // arguments that normally runs a complete transaction), retrying it
+      // on odb::timeout and odb::deadlock until the deadline expires.
+      //
+      template <typename F>
+      void
+      retry (F work);
+
+      // Total time the connection spent sleeping in the busy handler.
+      //
+      unsigned long long
+      blocked_time (const connection&) const;
+
+      // Total time for all the attached connections.
+      //
+      unsigned long long
+      blocked_time () const;
+
+    private:
+      contention_policy (const contention_policy&);
+      contention_policy& operator= (const contention_policy&);
+
+    private:
+      struct connection_state
+      {
+        connection_state (contention_policy& p, sqlite3* h)
+            : policy (&p), handle (h), waited (0), blocked (0), seed (0)
+        {
+        }
+
+        contention_policy* policy; // NULL once the policy is destroyed.
+        sqlite3* handle;
+        unsigned long long waited; // In the current busy episode.
+        details::atomic_count blocked;
+        unsigned int seed;
+      };
+
+      void
+      attach (sqlite3*);
+
+      static int
+      busy_handler (void* state, int count);
+
+      // Called by SQLite when the handle is closed or the state is
+      // replaced.
+      //
+      static void
+      detach (void* state);
+
+      static void
+      marker (sqlite3_context*, int, sqlite3_value**) {}
+
+      // Name of the per-connection client data (or, for older SQLite
+      // versions, of the marker function) that owns the state.
+      //
+      static const char*
+      key () {return "odb_contention_policy";}
+
+      // Sleep before attempt n (0-based) unless the time already waited
+      // (in microseconds) has reached the deadline. Return the time slept
+      // in microseconds (at least 1) or 0 if the deadline has passed.
+      //
+      unsigned long long
+      backoff (unsigned long long waited,
+               unsigned int n,
+               unsigned int& seed) const;
+
+      static unsigned long long
+      now ();
+
+    private:
+      unsigned int initial_delay_;
+      unsigned int max_delay_;
+      unsigned int deadline_;
+
+      typedef std::map<sqlite3*, connection_state*> connection_map;
+
+      mutable details::mutex mutex_;
+      connection_map connections_;
+    };
+
+    // Connection factory that attaches a contention policy to every
+    // connection returned by another factory. For example:
+    //
+    // sqlite::contention_policy p (1, 100, 2000);
+    //
+    // std::auto_ptr<sqlite::connection_factory> pf (
+    //   new sqlite::connection_pool_factory (8));
+    //
+    // std::auto_ptr<sqlite::connection_factory> f (
+    //   new sqlite::contention_connection_factory (p, pf));
+    //
+    // sqlite::database db ("app.db",
+    //                      SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+    //                      true,
+    //                      "",
+    //                      f);
+    //
+    class contention_connection_factory: public connection_factory
+    {
+    public:
+      contention_connection_factory (
+        contention_policy&, details::transfer_ptr<connection_factory>);
+
+      virtual connection_ptr
+      connect ();
+
+      virtual void
+      database (database_type&);
+
+    private:
+      contention_connection_factory (const contention_connection_factory&);
+      contention_connection_factory&
+      operator= (const contention_connection_factory&);
+
+    private:
+      contention_policy& policy_;
+      details::unique_ptr<connection_factory> factory_;
+    };
+  }
+}
+
+#include <odb/sqlite/contention-policy.ixx>
+#include <odb/sqlite/contention-policy.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_CONTENTION_POLICY_HXX
@@ -0,0 +1,279 @@
+// file      : odb/sqlite/contention-policy.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/details/lock.hxx>
+
+#ifdef ODB_CXX11
+#  include <chrono>
+#elif defined(ODB_THREADS_POSIX)
+#  include <sys/time.h> // gettimeofday
+#endif
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // contention_policy
+    //
+
+    inline contention_policy::
+    contention_policy (unsigned int initial_delay,
+                       unsigned int max_delay,
+                       unsigned int deadline)
+        : initial_delay_ (initial_delay != 0 ? initial_delay : 1),
+          max_delay_ (max_delay > initial_delay_ ? max_delay : initial_delay_),
+          deadline_ (deadline)
+    {
+    }
+
+    inline contention_policy::
+    ~contention_policy ()
+    {
+      // The states of the handles that are still open are owned by
+      // SQLite so we cannot free them. Instead, uninstall the busy
+      // handler and disown the states so that detach() only frees them.
+      //
+      connection_map m;
+
+      {
+        details::lock l (mutex_);
+
+        for (connection_map::iterator i (connections_.begin ());
+             i != connections_.end (); ++i)
+        {
+          sqlite3_busy_handler (i->first, 0, 0);
+          i->second->policy = 0;
+        }
+
+        m.swap (connections_);
+      }
+
+      // Now remove the states from the handles, which calls detach().
+      // If that fails, then the state is freed when the handle is closed.
+      //
+      for (connection_map::iterator i (m.begin ()); i != m.end (); ++i)
+      {
+#if SQLITE_VERSION_NUMBER >= 3044000
+        sqlite3_set_clientdata (i->first, key (), 0, 0);
+#else
+        sqlite3_create_function_v2 (
+          i->first, key (), 0, SQLITE_UTF8, 0, 0, 0, 0, 0);
+#endif
+      }
+    }
+
+    inline void contention_policy::
+    attach (connection& c)
+    {
+      attach (c.handle ());
+    }
+
+    inline void contention_policy::
+    attach (sqlite3* h)
+    {
+#if SQLITE_VERSION_NUMBER >= 3044000
+      // Fast path for a connection that we have already attached.
+      //
+      if (connection_state* s =
+          static_cast<connection_state*> (sqlite3_get_clientdata (h, key ())))
+      {
+        if (s->policy == this)
+          return;
+      }
+#endif
+
+      details::lock l (mutex_);
+
+      // A handle is erased when it is closed so if it is in the map,
+      // then it is the same connection.
+      //
+      if (connections_.find (h) != connections_.end ())
+        return;
+
+      details::unique_ptr<connection_state> s (
+        new connection_state (*this, h));
+
+      // Seed the jitter differently for each connection.
+      //
+      s->seed = static_cast<unsigned int> (
+        reinterpret_cast<std::size_t> (h) >> 4);
+
+      connections_.insert (connection_map::value_type (h, s.get ()));
+
+      // From now on the state is owned by the handle. If it was attached
+      // to another policy, then that policy's state is detached.
+      //
+      l.unlock ();
+
+#if SQLITE_VERSION_NUMBER >= 3044000
+      int e (sqlite3_set_clientdata (h, key (), s.get (), &detach));
+#else
+      int e (sqlite3_create_function_v2 (
+               h, key (), 0, SQLITE_UTF8, s.get (), &marker, 0, 0, &detach));
+#endif
+
+      // On failure SQLite calls the destructor itself.
+      //
+      connection_state* p (s.release ());
+
+      if (e != SQLITE_OK)
+        return;
+
+      sqlite3_busy_handler (h, &busy_handler, p);
+    }
+
+    inline void contention_policy::
+    detach (void* state)
+    {
+      connection_state* s (static_cast<connection_state*> (state));
+
+      if (contention_policy* p = s->policy)
+      {
+        details::lock l (p->mutex_);
+
+        connection_map::iterator i (p->connections_.find (s->handle));
+
+        if (i != p->connections_.end () && i->second == s)
+          p->connections_.erase (i);
+      }
+
+      delete s;
+    }
+
+    inline unsigned long long contention_policy::
+    blocked_time (const connection& c) const
+    {
+      details::lock l (mutex_);
+
+      connection_map::const_iterator i (
+        connections_.find (const_cast<connection&> (c).handle ()));
+
+      return i != connections_.end ()
+        ? details::atomic_load (i->second->blocked)
+        : 0;
+    }
+
+    inline unsigned long long contention_policy::
+    blocked_time () const
+    {
+      details::lock l (mutex_);
+
+      unsigned long long r (0);
+      for (connection_map::const_iterator i (connections_.begin ());
+           i != connections_.end (); ++i)
+        r += details::atomic_load (i->second->blocked);
+
+      return r;
+    }
+
+    inline int contention_policy::
+    busy_handler (void* state, int count)
+    {
+      connection_state& s (*static_cast<connection_state*> (state));
+
+      // Count is the number of times the handler has been called for
+      // this lock.
+      //
+      if (count == 0)
+        s.waited = 0;
+
+      unsigned int n (static_cast<unsigned int> (count));
+      unsigned long long t (s.policy->backoff (s.waited, n, s.seed));
+
+      if (t == 0)
+        return 0;
+
+      s.waited += t;
+      details::atomic_add (s.blocked, static_cast<std::size_t> (t));
+      return 1;
+    }
+
+    inline unsigned long long contention_policy::
+    backoff (unsigned long long waited,
+             unsigned int n,
+             unsigned int& seed) const
+    {
+      unsigned long long deadline (
+        static_cast<unsigned long long> (deadline_) * 1000);
+
+      if (waited >= deadline)
+        return 0;
+
+      unsigned long long d (initial_delay_);
+      for (; n != 0 && d < max_delay_; --n)
+        d <<= 1;
+
+      if (d > max_delay_)
+        d = max_delay_;
+
+      // Equal jitter: sleep between half and all of the delay.
+      //
+      seed = seed * 1103515245 + 12345;
+      d = d / 2 + (seed >> 16) % (d / 2 + 1);
+
+      // Do not sleep past the deadline.
+      //
+      unsigned long long left ((deadline - waited + 999) / 1000);
+      if (d > left)
+        d = left;
+
+      if (d == 0)
+        d = 1;
+
+      unsigned long long start (now ());
+      sqlite3_sleep (static_cast<int> (d));
+      unsigned long long end (now ());
+
+      // Fall back to the nominal delay if there is no clock.
+      //
+      unsigned long long r (end > start ? end - start : d * 1000);
+      return r != 0 ? r : 1;
+    }
+
+    inline unsigned long long contention_policy::
+    now ()
+    {
+#ifdef ODB_CXX11
+      using namespace std::chrono;
+
+      return static_cast<unsigned long long> (
+        duration_cast<microseconds> (
+          steady_clock::now ().time_since_epoch ()).count ());
+#elif defined(ODB_THREADS_POSIX)
+      timeval tv;
+      gettimeofday (&tv, 0);
+      return static_cast<unsigned long long> (tv.tv_sec) * 1000000 +
+        static_cast<unsigned long long> (tv.tv_usec);
+#else
+      return 0;
+#endif
+    }
+
+    //
+    // contention_connection_factory
+    //
+
+    inline contention_connection_factory::
+    contention_connection_factory (contention_policy& p,
+                                   details::transfer_ptr<connection_factory> f)
+        : policy_ (p), factory_ (f.transfer ())
+    {
+    }
+
+    inline connection_ptr contention_connection_factory::
+    connect ()
+    {
+      connection_ptr c (factory_->connect ());
+      policy_.attach (*c);
+      return c;
+    }
+
+    inline void contention_connection_factory::
+    database (database_type& db)
+    {
+      factory_->database (db);
+    }
+  }
+}
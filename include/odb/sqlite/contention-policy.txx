@@ -0,0 +1,37 @@
+// file      : odb/sqlite/contention-policy.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/exceptions.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename F>
+    void contention_policy::
+    retry (F work)
+    {
+      unsigned long long waited (0);
+      unsigned int seed (static_cast<unsigned int> (now ()));
+
+      for (unsigned int n (0);; ++n)
+      {
+        try
+        {
+          work ();
+          return;
+        }
+        catch (const odb::recoverable&)
+        {
+          unsigned long long t (backoff (waited, n, seed));
+
+          if (t == 0)
+            throw;
+
+          waited += t;
+        }
+      }
+    }
+  }
+}
@@ -10,6 +10,7 @@
 #include <sqlite3.h>
 
 #include <string>
+#include <vector>
 #include <memory> // std::auto_ptr, std::unique_ptr
 #include <iosfwd> // std::ostream
 
@@ -23,6 +24,7 @@
 #include <odb/sqlite/tracer.hxx>
 #include <odb/sqlite/connection.hxx>
 #include <odb/sqlite/connection-factory.hxx>
+#include <odb/sqlite/partial-update.hxx>
 #include <odb/sqlite/transaction-impl.hxx>
 
 #include <odb/sqlite/details/export.hxx>
@@ -137,6 +139,16 @@ namespace odb
       typename object_traits<T>::id_type
       persist (const typename object_traits<T>::pointer_type& obj_ptr);
 
+      // Make a range of objects persistent. See odb::database for details.
+      // If the object supports bulk operations, then the range is passed
+      // to the generated code in batches that reuse the same statements
+      // and image binding. In this case the iterator should be a forward
+      // iterator.
+      //
+      template <typename I>
+      void
+      persist (I begin, I end, bool continue_failed = true);
+
       // Load an object. Throw object_not_persistent if not found.
       //
       template <typename T>
@@ -187,6 +199,24 @@ namespace odb
       bool
       find (const typename object_traits<T>::id_type& id, T& object);
 
+      // Load a set of objects given a range of their ids. Objects that are
+      // not already in the session are fetched with as few SELECT statements
+      // as possible by batching their ids into IN (...) clauses sized to the
+      // SQLite host parameter limit. Loaded objects are added to the current
+      // session, if any. The returned pointers are in the same order as the
+      // ids. The load() version throws object_not_persistent if any of the
+      // objects is not found while find() returns a NULL pointer for such
+      // objects. The object pointer type should not be unique (for example,
+      // std::auto_ptr).
+      //
+      template <typename T, typename I>
+      std::vector<typename object_traits<T>::pointer_type>
+      load (I id_begin, I id_end);
+
+      template <typename T, typename I>
+      std::vector<typename object_traits<T>::pointer_type>
+      find (I id_begin, I id_end);
+
       // Update the state of a modified objects.
       //
       template <typename T>
@@ -217,6 +247,79 @@ namespace odb
       void
       update (const typename object_traits<T>::pointer_type& obj_ptr);
 
+      // Update a range of objects. See odb::database for details. As with
+      // persist(), objects that support bulk operations are updated in
+      // batches.
+      //
+      template <typename I>
+      void
+      update (I begin, I end, bool continue_failed = true);
+
+      // Make the object persistent if it does not yet exist in the
+      // database and update its state otherwise. Whether the object
+      // exists is determined from the session, if any, and then with an
+      // id lookup that does not load the object (there is no exception
+      // thrown and caught in either case). The object is then persisted
+      // or updated in the usual way, including optimistic concurrency
+      // checks (object_changed is thrown if the object is outdated),
+      // containers, callbacks, and the session. The object should have
+      // an id that is assigned by the application. Polymorphic objects
+      // should be passed as the root type.
+      //
+      template <typename T>
+      void
+      upsert (T& object);
+
+      template <typename T>
+      void
+      upsert (T* obj_ptr);
+
+      template <typename T, template <typename> class P>
+      void
+      upsert (const P<T>& obj_ptr);
+
+      template <typename T, typename A1, template <typename, typename> class P>
+      void
+      upsert (const P<T, A1>& obj_ptr);
+
+      template <typename T, template <typename> class P>
+      void
+      upsert (P<T>& obj_ptr);
+
+      template <typename T, typename A1, template <typename, typename> class P>
+      void
+      upsert (P<T, A1>& obj_ptr);
+
+      template <typename T>
+      void
+      upsert (const typename object_traits<T>::pointer_type& obj_ptr);
+
+      // Upsert a range of objects. The iterator value type can be an
+      // object or an object pointer. Failures (object_changed and, if
+      // the object was persisted concurrently, object_already_persistent)
+      // are handled as in the range update() above.
+      //
+      template <typename I>
+      void
+      upsert (I begin, I end, bool continue_failed = true);
+
+      // Track the object for partial updates. Subsequent updates of a
+      // tracked object only write the columns that have changed since
+      // it was tracked or last updated with this database. The object
+      // state is assumed to match the database (for example, it was
+      // just loaded or persisted). Objects are tracked per connection
+      // and only the connection of the current transaction is affected.
+      // Only non-polymorphic objects are supported. See partial_update
+      // for details.
+      //
+      template <typename T>
+      void
+      track (const T& object);
+
+      template <typename T>
+      void
+      untrack (const T& object);
+
       // Make the object transient. Throw object_not_persistent if not
       // found.
       //
@@ -252,6 +355,14 @@ namespace odb
       void
       erase (const typename object_traits<T>::pointer_type& obj_ptr);
 
+      // Erase a range of objects given their ids. See odb::database for
+      // details. As with persist(), objects that support bulk operations
+      // are erased in batches.
+      //
+      template <typename T, typename I>
+      void
+      erase (I id_begin, I id_end, bool continue_failed = true);
+
       // Erase multiple objects matching a query predicate.
       //
       template <typename T>
@@ -296,6 +407,15 @@ namespace odb
       result<T>
       query (const odb::query_base&);
 
+      // Execute a query built with query_builder. Only supported for
+      // non-polymorphic objects. The result refers to the builder's
+      // parameters so the builder should outlive it. This function is
+      // defined in <odb/sqlite/query-builder.hxx>.
+      //
+      template <typename T>
+      result<T>
+      query (const query_builder&);
+
       // Query preparation.
       //
       template <typename T>
@@ -362,6 +482,85 @@ namespace odb
       virtual odb::connection*
       connection_ ();
 
+    private:
+      template <typename T, typename I>
+      void
+      find_range_ (I id_begin,
+                   I id_end,
+                   std::vector<typename object_traits<T>::pointer_type>&);
+
+      template <typename T>
+      static std::string
+      id_column_ ();
+
+      // Return true if the object with this id exists in the session or
+      // in the database.
+      //
+      template <typename T>
+      bool
+      exists_ (const typename object_traits<T>::id_type&);
+
+      template <typename T>
+      void
+      upsert_ (T&);
+
+      template <typename T>
+      void
+      upsert_ (const typename object_traits<T>::pointer_type&);
+
+      template <typename I>
+      void
+      upsert_range_ (I begin, I end, bool continue_failed);
+
+      // Range operations. If the object traits support bulk operations,
+      // then the range is passed to them in batches. Otherwise, each
+      // element goes through the single-object function.
+      //
+      template <bool>
+      struct bulk_tag {};
+
+      template <typename I>
+      void
+      persist_range_ (I begin, I end, bool continue_failed);
+
+      template <typename I>
+      void
+      persist_range_ (I begin, I end, bool continue_failed, bulk_tag<true>);
+
+      template <typename I>
+      void
+      persist_range_ (I begin, I end, bool continue_failed, bulk_tag<false>);
+
+      template <typename I>
+      void
+      update_range_ (I begin, I end, bool continue_failed);
+
+      template <typename I>
+      void
+      update_range_ (I begin, I end, bool continue_failed, bulk_tag<true>);
+
+      template <typename I>
+      void
+      update_range_ (I begin, I end, bool continue_failed, bulk_tag<false>);
+
+      template <typename T, typename I>
+      void
+      erase_range_ (I id_begin, I id_end, bool continue_failed);
+
+      template <typename T, typename I>
+      void
+      erase_range_ (I id_begin,
+                    I id_end,
+                    bool continue_failed,
+                    bulk_tag<true>);
+
+      template <typename T, typename I>
+      void
+      erase_range_ (I id_begin,
+                    I id_end,
+                    bool continue_failed,
+                    bulk_tag<false>);
+
     private:
       std::string name_;
       int flags_;
@@ -373,6 +572,7 @@ namespace odb
 }
 
 #include <odb/sqlite/database.ixx>
+#include <odb/sqlite/database.txx>
 
 #include <odb/post.hxx>
 
@@ -93,6 +93,13 @@ namespace odb
       return persist_<T, id_sqlite> (pobj);
     }
 
+    template <typename I>
+    inline void database::
+    persist (I b, I e, bool cont)
+    {
+      persist_range_ (b, e, cont);
+    }
+
     template <typename T>
     inline typename object_traits<T>::pointer_type database::
     load (const typename object_traits<T>::id_type& id)
@@ -176,7 +183,9 @@ namespace odb
     inline void database::
     update (T& obj)
     {
+      partial_update::reset_pending ();
       update_<T, id_sqlite> (obj);
+      partial_update::confirm_pending ();
     }
 
     template <typename T>
@@ -191,7 +200,9 @@ namespace odb
       //
       const object_pointer& pobj (p);
 
+      partial_update::reset_pending ();
       update_<T, id_sqlite> (pobj);
+      partial_update::confirm_pending ();
     }
 
     template <typename T, template <typename> class P>
@@ -206,7 +217,9 @@ namespace odb
       //
       const object_pointer& pobj (p);
 
+      partial_update::reset_pending ();
       update_<T, id_sqlite> (pobj);
+      partial_update::confirm_pending ();
     }
 
     template <typename T, typename A1, template <typename, typename> class P>
@@ -221,7 +234,9 @@ namespace odb
       //
       const object_pointer& pobj (p);
 
+      partial_update::reset_pending ();
       update_<T, id_sqlite> (pobj);
+      partial_update::confirm_pending ();
     }
 
     template <typename T, template <typename> class P>
@@ -244,7 +259,98 @@ namespace odb
     inline void database::
     update (const typename object_traits<T>::pointer_type& pobj)
     {
+      partial_update::reset_pending ();
       update_<T, id_sqlite> (pobj);
+      partial_update::confirm_pending ();
+    }
+
+    template <typename I>
+    inline void database::
+    update (I b, I e, bool cont)
+    {
+      update_range_ (b, e, cont);
+    }
+
+    template <typename T>
+    inline void database::
+    upsert (T& obj)
+    {
+      upsert_<T> (obj);
+    }
+
+    template <typename T>
+    inline void database::
+    upsert (T* p)
+    {
+      typedef typename object_traits<T>::pointer_type object_pointer;
+
+      // The passed pointer should be the same or implicit-convertible
+      // to the object pointer. This way we make sure the object pointer
+      // does not assume ownership of the passed object.
+      //
+      const object_pointer& pobj (p);
+
+      upsert_<T> (pobj);
+    }
+
+    template <typename T, template <typename> class P>
+    inline void database::
+    upsert (const P<T>& p)
+    {
+      typedef typename object_traits<T>::pointer_type object_pointer;
+
+      // The passed pointer should be the same or implicit-convertible
+      // to the object pointer. This way we make sure the object pointer
+      // does not assume ownership of the passed object.
+      //
+      const object_pointer& pobj (p);
+
+      upsert_<T> (pobj);
+    }
+
+    template <typename T, typename A1, template <typename, typename> class P>
+    inline void database::
+    upsert (const P<T, A1>& p)
+    {
+      typedef typename object_traits<T>::pointer_type object_pointer;
+
+      // The passed pointer should be the same or implicit-convertible
+      // to the object pointer. This way we make sure the object pointer
+      // does not assume ownership of the passed object.
+      //
+      const object_pointer& pobj (p);
+
+      upsert_<T> (pobj);
+    }
+
+    template <typename T, template <typename> class P>
+    inline void database::
+    upsert (P<T>& p)
+    {
+      const P<T>& cr (p);
+      upsert<T, P> (cr);
+    }
+
+    template <typename T, typename A1, template <typename, typename> class P>
+    inline void database::
+    upsert (P<T, A1>& p)
+    {
+      const P<T, A1>& cr (p);
+      upsert<T, A1, P> (cr);
+    }
+
+    template <typename T>
+    inline void database::
+    upsert (const typename object_traits<T>::pointer_type& pobj)
+    {
+      upsert_<T> (pobj);
+    }
+
+    template <typename I>
+    inline void database::
+    upsert (I b, I e, bool cont)
+    {
+      upsert_range_ (b, e, cont);
     }
 
     template <typename T>
@@ -329,6 +435,13 @@ namespace odb
       erase_<T, id_sqlite> (pobj);
     }
 
+    template <typename T, typename I>
+    inline void database::
+    erase (I b, I e, bool cont)
+    {
+      erase_range_<T> (b, e, cont);
+    }
+
     template <typename T>
     inline unsigned long long database::
     erase_query ()
@@ -0,0 +1,677 @@
+// file      : odb/sqlite/database.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <map>
+#include <vector>
+#include <cstddef>  // std::size_t
+#include <iterator> // std::iterator_traits
+
+#include <odb/exceptions.hxx>
+#include <odb/pointer-traits.hxx>
+#include <odb/no-op-cache-traits.hxx>
+
+#include <odb/sqlite/statement.hxx>
+#include <odb/sqlite/transaction.hxx>
+#include <odb/sqlite/statement-cache.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // The statement that finds the complete object by id. Polymorphic
+    // derived objects have one find statement per hierarchy level with
+    // the first one joining all of them.
+    //
+    template <typename T, typename R>
+    struct object_find_statement_impl
+    {
+      static const char*
+      text ()
+      {
+        return object_traits_impl<T, id_sqlite>::find_statements[0];
+      }
+    };
+
+    template <typename T>
+    struct object_find_statement_impl<T, T>
+    {
+      static const char*
+      text ()
+      {
+        return object_traits_impl<T, id_sqlite>::find_statement;
+      }
+    };
+
+    template <typename T, bool polymorphic = object_traits<T>::polymorphic>
+    struct object_find_statement: object_find_statement_impl<T, T> {};
+
+    template <typename T>
+    struct object_find_statement<T, true>:
+      object_find_statement_impl<T, typename object_traits<T>::root_type> {};
+
+    // Batch size for the bulk operations on the object. The generated
+    // code only defines it for objects that support them, so 1 (no bulk
+    // operations) is used if it is absent.
+    //
+    template <typename T>
+    struct object_batch_p
+    {
+      template <std::size_t>
+      struct probe {};
+
+      template <typename X>
+      static char
+      test (probe<X::batch>*);
+
+      template <typename X>
+      static long
+      test (...);
+
+      static const bool result =
+        sizeof (test<object_traits_impl<T, id_sqlite> > (0)) == 1;
+    };
+
+    template <typename T, bool = object_batch_p<T>::result>
+    struct object_batch
+    {
+      static const std::size_t value = 1;
+    };
+
+    template <typename T>
+    struct object_batch<T, true>
+    {
+      static const std::size_t value = object_traits_impl<T, id_sqlite>::batch;
+    };
+
+    template <typename X>
+    struct range_const
+    {
+      static const bool result = false;
+    };
+
+    template <typename X>
+    struct range_const<const X>
+    {
+      static const bool result = true;
+    };
+
+    template <typename R>
+    struct range_reference;
+
+    template <typename X>
+    struct range_reference<X&>
+    {
+      typedef X type;
+    };
+
+    // Element of a range whose value type is an object.
+    //
+    template <typename I,
+              typename V = typename std::iterator_traits<I>::value_type,
+              bool = class_traits<V>::kind == class_object>
+    struct range_element
+    {
+      typedef
+      typename range_reference<
+        typename std::iterator_traits<I>::reference>::type
+      element_type;
+
+      typedef V object_type;
+
+      static element_type&
+      get_ref (const I& i)
+      {
+        return *i;
+      }
+
+      // Add the persistent object to the session, if any.
+      //
+      static void
+      cache (odb::database& db, const I& i)
+      {
+        typedef object_traits_impl<object_type, id_sqlite> object_traits;
+        typedef typename object_traits::reference_cache_traits cache_traits;
+
+        typename cache_traits::position_type p (
+          cache_traits::insert (
+            db, reference_cache_type<element_type>::convert (*i)));
+
+        cache_traits::persist (p);
+      }
+    };
+
+    // Element of a range whose value type is an object pointer.
+    //
+    template <typename I, typename P>
+    struct range_element<I, P, false>
+    {
+      typedef typename odb::pointer_traits<P>::element_type element_type;
+      typedef typename object_traits<element_type>::object_type object_type;
+
+      static element_type&
+      get_ref (const I& i)
+      {
+        return odb::pointer_traits<P>::get_ref (*i);
+      }
+
+      static void
+      cache (odb::database& db, const I& i)
+      {
+        typedef object_traits_impl<object_type, id_sqlite> object_traits;
+        typedef typename object_traits::pointer_cache_traits cache_traits;
+
+        typename cache_traits::position_type p (
+          cache_traits::insert (db, pointer_cache_type<P>::convert (*i)));
+
+        cache_traits::persist (p);
+      }
+    };
+
+    template <typename T, typename I>
+    std::vector<typename object_traits<T>::pointer_type> database::
+    load (I b, I e)
+    {
+      typedef typename object_traits<T>::pointer_type pointer_type;
+      typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+      std::vector<pointer_type> r;
+      find_range_<T> (b, e, r);
+
+      for (typename std::vector<pointer_type>::const_iterator i (r.begin ());
+           i != r.end (); ++i)
+      {
+        if (pointer_traits::null_ptr (*i))
+          throw object_not_persistent ();
+      }
+
+      return r;
+    }
+
+    template <typename T, typename I>
+    std::vector<typename object_traits<T>::pointer_type> database::
+    find (I b, I e)
+    {
+      std::vector<typename object_traits<T>::pointer_type> r;
+      find_range_<T> (b, e, r);
+      return r;
+    }
+
+    template <typename T, typename I>
+    void database::
+    find_range_ (I b,
+                 I e,
+                 std::vector<typename object_traits<T>::pointer_type>& r)
+    {
+      // T is always object_type.
+      //
+      typedef object_traits_impl<T, id_sqlite> object_traits;
+      typedef typename object_traits::id_type id_type;
+      typedef typename object_traits::pointer_type pointer_type;
+      typedef typename object_traits::pointer_cache_traits cache_traits;
+      typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+      typedef std::map<id_type, pointer_type> object_map;
+
+      // Resolve what we can from the session and collect the rest. The
+      // map also takes care of duplicate ids in the range.
+      //
+      std::vector<id_type> ids;
+      std::vector<id_type> missing;
+      object_map objs;
+
+      for (; b != e; ++b)
+      {
+        ids.push_back (*b);
+        const id_type& id (ids.back ());
+
+        if (objs.find (id) != objs.end ())
+          continue;
+
+        // For polymorphic objects the session holds root pointers.
+        //
+        typedef typename cache_traits::pointer_type cache_pointer_type;
+        typedef odb::pointer_traits<cache_pointer_type> cache_pointer_traits;
+
+        pointer_type p = pointer_type ();
+        cache_pointer_type cp (cache_traits::find (*this, id));
+
+        if (!cache_pointer_traits::null_ptr (cp))
+          p = cache_pointer_traits::template dynamic_pointer_cast<T> (cp);
+        else
+          missing.push_back (id);
+
+        objs.insert (typename object_map::value_type (id, p));
+      }
+
+      if (!missing.empty ())
+      {
+        std::string column (id_column_<T> ());
+
+        if (column.empty ())
+        {
+          // Composite or otherwise unusual object id. Fall back to loading
+          // the objects one by one.
+          //
+          for (typename std::vector<id_type>::const_iterator i (
+                 missing.begin ()); i != missing.end (); ++i)
+            objs[*i] = find_<T, id_sqlite> (*i);
+        }
+        else
+        {
+          sqlite::connection& c (transaction::current ().connection ());
+          int limit (
+            sqlite3_limit (c.handle (), SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+
+          std::size_t chunk (
+            limit > 0 ? static_cast<std::size_t> (limit) : 1);
+
+          for (std::size_t i (0), n (missing.size ()); i != n;)
+          {
+            std::size_t m (n - i < chunk ? n - i : chunk);
+
+            query_base q (column);
+            q += "IN (";
+
+            for (std::size_t j (i); j != i + m; ++j)
+            {
+              if (j != i)
+                q += ",";
+
+              q += query_base::_val (missing[j]);
+            }
+
+            q += ")";
+
+            // Loading an object via the result iterator adds it to the
+            // session.
+            //
+            result<T> res (query<T> (q));
+
+            for (typename result<T>::iterator k (res.begin ());
+                 k != res.end (); ++k)
+            {
+              pointer_type p (k.load ());
+              objs[object_traits::id (pointer_traits::get_ref (p))] = p;
+            }
+
+            i += m;
+          }
+        }
+      }
+
+      r.reserve (r.size () + ids.size ());
+
+      for (typename std::vector<id_type>::const_iterator i (ids.begin ());
+           i != ids.end (); ++i)
+        r.push_back (objs[*i]);
+    }
+
+    template <typename T>
+    std::string database::
+    id_column_ ()
+    {
+      // Extract the qualified id column name from the object's find
+      // statement which ends with the "WHERE <column>=?" clause. An empty
+      // string is returned if the id is not a single column.
+      //
+      std::string s (object_find_statement<T>::text ());
+
+      std::string::size_type p (s.rfind (" WHERE "));
+
+      if (p == std::string::npos)
+        return std::string ();
+
+      s.erase (0, p + 7);
+      p = s.size ();
+
+      if (p < 3 || s.compare (p - 2, 2, "=?") != 0 ||
+          s.find ('?') != p - 1)
+        return std::string ();
+
+      s.resize (p - 2);
+      return s;
+    }
+
+    template <typename T>
+    bool database::
+    exists_ (const typename object_traits<T>::id_type& id)
+    {
+      // T is always object_type.
+      //
+      typedef object_traits_impl<T, id_sqlite> object_traits;
+      typedef typename object_traits::pointer_type pointer_type;
+      typedef typename object_traits::pointer_cache_traits cache_traits;
+      typedef typename object_traits::statements_type statements_type;
+      typedef typename object_traits::id_image_type id_image_type;
+
+      if (!odb::pointer_traits<pointer_type>::null_ptr (
+            cache_traits::find (*this, id)))
+        return true;
+
+      sqlite::connection& c (transaction::current ().connection ());
+      statements_type& sts (c.statement_cache ().find_object<T> ());
+
+      id_image_type& i (sts.id_image ());
+      object_traits::init (i, id);
+
+      binding& idb (sts.id_image_binding ());
+
+      if (i.version != sts.id_image_version () || idb.version == 0)
+      {
+        object_traits::bind (idb.bind, i);
+        sts.id_image_version (i.version);
+        idb.version++;
+      }
+
+      select_statement& st (sts.exists_statement ());
+      st.execute ();
+      auto_result ar (st);
+
+      return st.next ();
+    }
+
+    template <typename T>
+    void database::
+    upsert_ (T& obj)
+    {
+      // T can be const T while object_type will always be T.
+      //
+      typedef typename object_traits<T>::object_type object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+
+      if (exists_<object_type> (object_traits::id (obj)))
+      {
+        partial_update::reset_pending ();
+        update_<T, id_sqlite> (obj);
+        partial_update::confirm_pending ();
+      }
+      else
+        persist_<T, id_sqlite> (obj);
+    }
+
+    template <typename T>
+    void database::
+    upsert_ (const typename object_traits<T>::pointer_type& pobj)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+      typedef typename object_traits<T>::pointer_type pointer_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+
+      T& obj (odb::pointer_traits<pointer_type>::get_ref (pobj));
+
+      if (exists_<object_type> (object_traits::id (obj)))
+      {
+        partial_update::reset_pending ();
+        update_<T, id_sqlite> (pobj);
+        partial_update::confirm_pending ();
+      }
+      else
+        persist_<T, id_sqlite> (pobj);
+    }
+
+    template <typename I>
+    void database::
+    upsert_range_ (I b, I e, bool cont)
+    {
+      multiple_exceptions mex;
+      std::size_t n (0);
+
+      for (; b != e; ++b)
+      {
+        try
+        {
+          n++;
+          upsert (*b);
+        }
+        catch (const object_changed& ex)
+        {
+          mex.insert (n - 1, ex);
+
+          if (!cont)
+            break;
+        }
+        catch (const object_already_persistent& ex)
+        {
+          mex.insert (n - 1, ex);
+
+          if (!cont)
+            break;
+        }
+      }
+
+      if (!mex.empty ())
+      {
+        mex.attempted (n);
+        mex.prepare ();
+        throw mex;
+      }
+    }
+
+    template <typename I>
+    inline void database::
+    persist_range_ (I b, I e, bool cont)
+    {
+      typedef range_element<I> element;
+      typedef typename element::object_type object_type;
+
+      // The bulk functions take the objects by non-const pointer.
+      //
+      persist_range_ (
+        b, e, cont,
+        bulk_tag<(object_batch<object_type>::value > 1 &&
+                  !range_const<typename element::element_type>::result)> ());
+    }
+
+    template <typename I>
+    inline void database::
+    persist_range_ (I b, I e, bool cont, bulk_tag<false>)
+    {
+      odb::database::persist_range_ (*this, b, e, cont);
+    }
+
+    template <typename I>
+    void database::
+    persist_range_ (I b, I e, bool cont, bulk_tag<true>)
+    {
+      typedef range_element<I> element;
+      typedef typename element::object_type object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+
+      const std::size_t batch (object_batch<object_type>::value);
+
+      std::vector<object_type*> objs;
+      objs.reserve (batch);
+
+      multiple_exceptions mex;
+      std::size_t n (0);
+
+      while (b != e)
+      {
+        I bb (b);
+
+        objs.clear ();
+        for (; b != e && objs.size () != batch; ++b)
+          objs.push_back (&element::get_ref (b));
+
+        std::size_t f (mex.size ());
+        mex.delta (n);
+
+        std::size_t m (
+          object_traits::persist (*this, &objs[0], objs.size (), mex, cont));
+
+        // Add the persisted objects to the session. The failed ones are
+        // recorded at the end of mex in the order of their positions.
+        //
+        multiple_exceptions::iterator fi (mex.begin () + f);
+
+        for (std::size_t i (0); i != m; ++i, ++bb)
+        {
+          if (fi != mex.end () && fi->position () == n + i)
+            ++fi;
+          else
+            element::cache (*this, bb);
+        }
+
+        n += m;
+
+        if (!cont && mex.size () != f)
+          break;
+      }
+
+      if (!mex.empty ())
+      {
+        mex.attempted (n);
+        mex.prepare ();
+        throw mex;
+      }
+    }
+
+    template <typename I>
+    inline void database::
+    update_range_ (I b, I e, bool cont)
+    {
+      typedef typename range_element<I>::object_type object_type;
+
+      update_range_ (
+        b, e, cont, bulk_tag<(object_batch<object_type>::value > 1)> ());
+    }
+
+    template <typename I>
+    inline void database::
+    update_range_ (I b, I e, bool cont, bulk_tag<false>)
+    {
+      odb::database::update_range_ (*this, b, e, cont);
+    }
+
+    template <typename I>
+    void database::
+    update_range_ (I b, I e, bool cont, bulk_tag<true>)
+    {
+      typedef range_element<I> element;
+      typedef typename element::object_type object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+
+      const std::size_t batch (object_batch<object_type>::value);
+
+      std::vector<const object_type*> objs;
+      objs.reserve (batch);
+
+      multiple_exceptions mex;
+      std::size_t n (0);
+
+      // The bulk update() keeps the session consistent for each element
+      // that it updates.
+      //
+      while (b != e)
+      {
+        objs.clear ();
+        for (; b != e && objs.size () != batch; ++b)
+          objs.push_back (&element::get_ref (b));
+
+        std::size_t f (mex.size ());
+        mex.delta (n);
+
+        n += object_traits::update (*this, &objs[0], objs.size (), mex, cont);
+
+        if (!cont && mex.size () != f)
+          break;
+      }
+
+      if (!mex.empty ())
+      {
+        mex.attempted (n);
+        mex.prepare ();
+        throw mex;
+      }
+    }
+
+    template <typename T, typename I>
+    inline void database::
+    erase_range_ (I b, I e, bool cont)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+
+      erase_range_<T> (
+        b, e, cont, bulk_tag<(object_batch<object_type>::value > 1)> ());
+    }
+
+    template <typename T, typename I>
+    inline void database::
+    erase_range_ (I b, I e, bool cont, bulk_tag<false>)
+    {
+      odb::database::erase_range_<T> (*this, b, e, cont);
+    }
+
+    template <typename T, typename I>
+    void database::
+    erase_range_ (I b, I e, bool cont, bulk_tag<true>)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+      typedef typename object_traits::id_type id_type;
+
+      const std::size_t batch (object_batch<object_type>::value);
+
+      // The iterator value type only has to be convertible to the id
+      // type so copy the ids of each batch.
+      //
+      std::vector<id_type> ids;
+      ids.reserve (batch);
+
+      multiple_exceptions mex;
+      std::size_t n (0);
+
+      while (b != e)
+      {
+        ids.clear ();
+        for (; b != e && ids.size () != batch; ++b)
+        {
+          const id_type& id (*b);
+          ids.push_back (id);
+        }
+
+        std::size_t f (mex.size ());
+        mex.delta (n);
+
+        n += object_traits::erase (*this, &ids[0], ids.size (), mex, cont);
+
+        if (!cont && mex.size () != f)
+          break;
+      }
+
+      if (!mex.empty ())
+      {
+        mex.attempted (n);
+        mex.prepare ();
+        throw mex;
+      }
+    }
+
+    template <typename T>
+    void database::
+    track (const T& obj)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+      typedef typename object_traits::statements_type statements_type;
+
+      sqlite::connection& c (transaction::current ().connection ());
+      statements_type& sts (c.statement_cache ().find_object<object_type> ());
+      sts.track (obj);
+    }
+
+    template <typename T>
+    void database::
+    untrack (const T& obj)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+      typedef typename object_traits::statements_type statements_type;
+
+      sqlite::connection& c (transaction::current ().connection ());
+      statements_type& sts (c.statement_cache ().find_object<object_type> ());
+      sts.untrack (obj);
+    }
+  }
+}
@@ -27,6 +27,7 @@ namespace odb
     class statement;
     class transaction;
     class tracer;
+    class query_builder;
 
     namespace core
     {
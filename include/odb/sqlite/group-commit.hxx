@@ -0,0 +1,164 @@
+// file      : odb/sqlite/group-commit.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_GROUP_COMMIT_HXX
+#define ODB_SQLITE_GROUP_COMMIT_HXX
+
+#include <odb/pre.hxx>
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/exception.hxx>
+
+#include <odb/details/config.hxx> // ODB_CXX11
+#include <odb/details/mutex.hxx>
+#include <odb/details/condition.hxx>
+
+#ifdef ODB_CXX11
+#  include <exception> // std::exception_ptr
+#endif
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/database.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Thrown in the caller's thread if its unit of work or the shared
+    // commit failed and the original exception cannot be transported
+    // (C++98). In C++11 the original exception is rethrown instead.
+    //
+    struct group_commit_error: odb::exception
+    {
+      explicit
+      group_commit_error (const std::string& message): message_ (message) {}
+
+      ~group_commit_error () throw () {}
+
+      virtual const char*
+      what () const throw ()
+      {
+        return message_.c_str ();
+      }
+
+    private:
+      std::string message_;
+    };
+
+    // Group commit coordinator. Short write transactions submitted from
+    // multiple threads are merged into a single SQLite transaction which
+    // is committed (and synced to disk) once for the whole group.
+    //
+    // A unit of work is a function object that is called without any
+    // arguments and performs its database operations in the current
+    // transaction. One of the submitting threads becomes the leader and
+    // executes the work of all the queued callers on a single connection,
+    // each unit in its own savepoint. If a unit throws, only its savepoint
+    // is rolled back and the exception is delivered to its caller. If the
+    // commit itself fails, all the callers whose work succeeded get the
+    // commit exception. The execute() function returns only after the
+    // shared commit has completed.
+    //
+    // Because the work may be executed in another thread, it should not
+    // rely on thread-local state such as the current session. The
+    // execute() function should not be called while a transaction is
+    // already in effect in the calling thread.
+    //
+    class group_commit
+    {
+    public:
+      typedef sqlite::database database_type;
+
+      // The max_batch argument specifies the maximum number of units of
+      // work merged into a single transaction. If this value is 0, then
+      // all the queued work is merged.
+      //
+      explicit
+      group_commit (database_type&, std::size_t max_batch = 0);
+
+      template <typename F>
+      void
+      execute (F work);
+
+    private:
+      group_commit (const group_commit&);
+      group_commit& operator= (const group_commit&);
+
+    private:
+      struct job
+      {
+        job (details::mutex& m): done (false), failed (false), cond (m) {}
+
+        virtual
+        ~job () {}
+
+        virtual void
+        run () = 0;
+
+        // Save the exception currently being handled.
+        //
+        void
+        capture ();
+
+        void
+        rethrow ();
+
+        bool done;
+        bool failed;
+        details::condition cond;
+
+#ifdef ODB_CXX11
+        std::exception_ptr exception;
+#else
+        std::string message;
+#endif
+      };
+
+      template <typename F>
+      struct job_impl: job
+      {
+        job_impl (details::mutex& m, F& w): job (m), work (w) {}
+
+        virtual void
+        run ()
+        {
+          work ();
+        }
+
+        F& work;
+      };
+
+      // Execute the queued work as the leader. Called and returns with
+      // the mutex locked.
+      //
+      void
+      lead ();
+
+      // Execute the batch in a single transaction. Does not throw.
+      //
+      void
+      execute_batch (std::vector<job*>&);
+
+    private:
+      database_type& db_;
+      std::size_t max_batch_;
+
+      details::mutex mutex_;
+      std::deque<job*> pending_;
+      bool leader_;
+    };
+  }
+}
+
+#include <odb/sqlite/group-commit.ixx>
+#include <odb/sqlite/group-commit.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_GROUP_COMMIT_HXX
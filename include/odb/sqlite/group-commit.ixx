@@ -0,0 +1,129 @@
+// file      : odb/sqlite/group-commit.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <exception> // std::exception
+
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/transaction.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    inline group_commit::
+    group_commit (database_type& db, std::size_t max_batch)
+        : db_ (db), max_batch_ (max_batch), leader_ (false)
+    {
+    }
+
+    inline void group_commit::
+    lead ()
+    {
+      std::vector<job*> batch;
+
+      std::size_t n (pending_.size ());
+      if (max_batch_ != 0 && n > max_batch_)
+        n = max_batch_;
+
+      batch.assign (pending_.begin (), pending_.begin () + n);
+      pending_.erase (pending_.begin (), pending_.begin () + n);
+      leader_ = true;
+
+      mutex_.unlock ();
+      execute_batch (batch);
+      mutex_.lock ();
+
+      leader_ = false;
+
+      // Our own job is marked done but is not waiting on its condition.
+      //
+      for (std::vector<job*>::iterator i (batch.begin ());
+           i != batch.end (); ++i)
+      {
+        (*i)->done = true;
+        (*i)->cond.signal ();
+      }
+
+      // Hand the leadership over to the first waiting caller, if any.
+      //
+      if (!pending_.empty ())
+        pending_.front ()->cond.signal ();
+    }
+
+    inline void group_commit::
+    execute_batch (std::vector<job*>& batch)
+    {
+      try
+      {
+        connection_ptr c (db_.connection ());
+        transaction t (c->begin_immediate ());
+
+        for (std::vector<job*>::iterator i (batch.begin ());
+             i != batch.end (); ++i)
+        {
+          c->execute ("SAVEPOINT odb_group_commit");
+
+          try
+          {
+            (*i)->run ();
+          }
+          catch (...)
+          {
+            (*i)->capture ();
+            c->execute ("ROLLBACK TO SAVEPOINT odb_group_commit");
+          }
+
+          c->execute ("RELEASE SAVEPOINT odb_group_commit");
+        }
+
+        t.commit ();
+      }
+      catch (...)
+      {
+        // The transaction failed as a whole so report this failure to
+        // everyone who has not failed on their own.
+        //
+        for (std::vector<job*>::iterator i (batch.begin ());
+             i != batch.end (); ++i)
+        {
+          if (!(*i)->failed)
+            (*i)->capture ();
+        }
+      }
+    }
+
+    inline void group_commit::job::
+    capture ()
+    {
+      failed = true;
+
+#ifdef ODB_CXX11
+      exception = std::current_exception ();
+#else
+      try
+      {
+        throw;
+      }
+      catch (const std::exception& e)
+      {
+        message = e.what ();
+      }
+      catch (...)
+      {
+        message = "unknown exception";
+      }
+#endif
+    }
+
+    inline void group_commit::job::
+    rethrow ()
+    {
+#ifdef ODB_CXX11
+      std::rethrow_exception (exception);
+#else
+      throw group_commit_error (message);
+#endif
+    }
+  }
+}
@@ -0,0 +1,37 @@
+// file      : odb/sqlite/group-commit.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/details/lock.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename F>
+    void group_commit::
+    execute (F work)
+    {
+      job_impl<F> j (mutex_, work);
+
+      {
+        details::lock l (mutex_);
+        pending_.push_back (&j);
+
+        // Either someone else executes our work and wakes us up when it
+        // is committed or we become the leader and do it ourselves.
+        //
+        while (!j.done)
+        {
+          if (!leader_)
+            lead ();
+          else
+            j.cond.wait ();
+        }
+      }
+
+      if (j.failed)
+        j.rethrow ();
+    }
+  }
+}
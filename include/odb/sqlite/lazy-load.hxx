@@ -0,0 +1,48 @@
+// file      : odb/sqlite/lazy-load.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_LAZY_LOAD_HXX
+#define ODB_SQLITE_LAZY_LOAD_HXX
+
+#include <odb/pre.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Load the objects pointed to by the unloaded lazy pointers in the
+    // [begin, end) range. Instead of issuing one SELECT per pointer, as
+    // calling load() on each of them would, the ids are collected and
+    // the objects are fetched with the batched database::find() (that
+    // is, with as few IN (...) queries as the host parameter limit
+    // allows). Objects that are already in the session are not fetched
+    // again and newly loaded objects are added to it. Each pointer is
+    // then reset to point to its object.
+    //
+    // The iterator should be a forward iterator over lazy pointers to
+    // objects of the same type, for example, lazy_shared_ptr<employee>.
+    // The object pointer type should not be unique. Pointers that are
+    // NULL or already loaded are left alone as are those that belong to
+    // a database other than that of the current transaction. If an
+    // object is not found, its pointer stays unloaded and a subsequent
+    // load() throws object_not_persistent as usual. For example:
+    //
+    // transaction t (db.begin ());
+    // sqlite::lazy_load_all (emp.colleagues.begin (),
+    //                        emp.colleagues.end ());
+    //
+    template <typename I>
+    void
+    lazy_load_all (I begin, I end);
+  }
+}
+
+#include <odb/sqlite/lazy-load.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_LAZY_LOAD_HXX
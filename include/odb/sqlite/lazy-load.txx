@@ -0,0 +1,59 @@
+// file      : odb/sqlite/lazy-load.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <vector>
+#include <cstddef>  // std::size_t
+#include <iterator> // std::iterator_traits
+
+#include <odb/traits.hxx>
+#include <odb/pointer-traits.hxx>
+
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/transaction.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename I>
+    void
+    lazy_load_all (I b, I e)
+    {
+      typedef typename std::iterator_traits<I>::value_type lazy_pointer;
+      typedef typename lazy_pointer::element_type element_type;
+      typedef typename object_traits<element_type>::object_type object_type;
+      typedef typename object_traits<object_type>::id_type id_type;
+      typedef typename object_traits<object_type>::pointer_type pointer_type;
+      typedef odb::pointer_traits<pointer_type> pointer_traits;
+
+      database& db (transaction::current ().database ());
+
+      std::vector<I> ptrs;
+      std::vector<id_type> ids;
+
+      for (; b != e; ++b)
+      {
+        const lazy_pointer& p (*b);
+
+        if (p.loaded () || &p.database () != &db)
+          continue;
+
+        ptrs.push_back (b);
+        ids.push_back (p.template object_id<object_type> ());
+      }
+
+      if (ids.empty ())
+        return;
+
+      std::vector<pointer_type> objs (
+        db.find<object_type> (ids.begin (), ids.end ()));
+
+      for (std::size_t i (0), n (ptrs.size ()); i != n; ++i)
+      {
+        if (!pointer_traits::null_ptr (objs[i]))
+          ptrs[i]->reset (db, objs[i]);
+      }
+    }
+  }
+}
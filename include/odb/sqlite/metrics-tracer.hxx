@@ -0,0 +1,252 @@
+// file      : odb/sqlite/metrics-tracer.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_METRICS_TRACER_HXX
+#define ODB_SQLITE_METRICS_TRACER_HXX
+
+#include <odb/pre.hxx>
+
+#include <sqlite3.h>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iosfwd>  // std::ostream
+#include <cstddef> // std::size_t
+
+#include <odb/details/mutex.hxx>
+#include <odb/details/atomic.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/tracer.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Point-in-time copy of a metrics_histogram. Only non-empty buckets
+    // are included and are ordered by their upper bound.
+    //
+    struct histogram_snapshot
+    {
+      struct bucket
+      {
+        unsigned long long upper; // Inclusive upper bound.
+        std::size_t count;
+      };
+
+      histogram_snapshot (): count (0), sum (0) {}
+
+      // Return the upper bound of the bucket containing the specified
+      // percentile (between 0 and 100) or 0 if the histogram is empty.
+      //
+      unsigned long long
+      percentile (double) const;
+
+      std::vector<bucket> buckets;
+      std::size_t count;
+      std::size_t sum;
+    };
+
+    // HDR-style log-linear histogram with 4 sub-buckets per power of two
+    // (that is, at most 25% relative error) covering the whole 64-bit
+    // range. Recording is lock-free.
+    //
+    class metrics_histogram
+    {
+    public:
+      static const std::size_t bucket_count = 252;
+
+      metrics_histogram ();
+
+      void
+      record (unsigned long long);
+
+      histogram_snapshot
+      snapshot () const;
+
+      static std::size_t
+      index (unsigned long long);
+
+      static unsigned long long
+      lower_bound (std::size_t index);
+
+      static unsigned long long
+      upper_bound (std::size_t index);
+
+    private:
+      metrics_histogram (const metrics_histogram&);
+      metrics_histogram& operator= (const metrics_histogram&);
+
+    private:
+      mutable details::atomic_count buckets_[bucket_count];
+      mutable details::atomic_count count_;
+      mutable details::atomic_count sum_;
+    };
+
+    // Metrics for a single statement text. Durations are in microseconds.
+    //
+    struct statement_metrics
+    {
+      std::string text;
+      std::size_t prepares;
+
+      // Time from the start of execution until the first row is returned
+      // (or the statement completes if it returns no rows), total step
+      // time for the execution, and the number of rows returned. The
+      // total histogram's count is the number of executions.
+      //
+      histogram_snapshot first_step;
+      histogram_snapshot total;
+      histogram_snapshot rows;
+
+      // Accumulated sqlite3_stmt_status() counters.
+      //
+      std::size_t full_scan_steps;
+      std::size_t sorts;
+      std::size_t auto_indexes;
+      std::size_t vm_steps;
+    };
+
+    // Tracer that collects per-statement execution metrics. For example:
+    //
+    // sqlite::metrics_tracer metrics;
+    // db.tracer (metrics);
+    // ...
+    // metrics.dump ("/var/lib/app/odb.prom");
+    //
+    // Statements are registered when they are prepared and their
+    // execution is observed with sqlite3_trace_v2() which is installed on
+    // each connection that prepares a statement. As a result, timing is
+    // only available with SQLite 3.14.0 or later. With earlier versions
+    // only the prepare counts are collected. The time to prepare a
+    // statement is not reported since the prepare() hook is called after
+    // the statement has been prepared.
+    //
+    // The same tracer can be used by multiple connections concurrently.
+    // It must outlive all the connections that it was used with and it
+    // replaces any other sqlite3_trace_v2() callback on these
+    // connections.
+    //
+    class metrics_tracer: public tracer
+    {
+    public:
+      metrics_tracer () {}
+
+      virtual
+      ~metrics_tracer ();
+
+      virtual void
+      prepare (connection&, const statement&);
+
+      virtual void
+      execute (connection&, const statement&);
+
+      virtual void
+      execute (connection&, const char* statement);
+
+      virtual void
+      deallocate (connection&, const statement&);
+
+    public:
+      std::vector<statement_metrics>
+      snapshot () const;
+
+      // Write the metrics in the Prometheus text exposition format.
+      //
+      void
+      dump (std::ostream&) const;
+
+      // Write the metrics to the file. The data is first written to a
+      // temporary file which then replaces the original so that readers
+      // never see a partially written file. Throw std::ios_base::failure
+      // on error.
+      //
+      void
+      dump (const std::string& path) const;
+
+    private:
+      metrics_tracer (const metrics_tracer&);
+      metrics_tracer& operator= (const metrics_tracer&);
+
+    private:
+      struct statement_stats
+      {
+        explicit
+        statement_stats (const std::string& t)
+            : text (t), prepares (0), full_scan_steps (0), sorts (0),
+              auto_indexes (0), vm_steps (0)
+        {
+        }
+
+        std::string text;
+        details::atomic_count prepares;
+        details::atomic_count full_scan_steps;
+        details::atomic_count sorts;
+        details::atomic_count auto_indexes;
+        details::atomic_count vm_steps;
+
+        metrics_histogram first_step;
+        metrics_histogram total;
+        metrics_histogram rows;
+      };
+
+      // An execution in progress.
+      //
+      struct run
+      {
+        sqlite3_stmt* stmt;
+        statement_stats* stats;
+        unsigned long long start;
+        std::size_t rows;
+      };
+
+      // Per-connection state passed to the trace callback. It is only
+      // accessed by the thread currently using the connection except for
+      // the statements map which is modified under the tracer's mutex
+      // from the same thread.
+      //
+      struct connection_state
+      {
+        typedef std::map<sqlite3_stmt*, statement_stats*> statement_map;
+
+        statement_map statements;
+        std::vector<run> runs;
+      };
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+      static int
+      trace (unsigned int type, void* state, void* p, void* x);
+
+      static void
+      complete (run&, unsigned long long elapsed);
+#endif
+
+      static unsigned long long
+      now ();
+
+      static void
+      dump_histogram (std::ostream&,
+                      const char* name,
+                      const std::string& labels,
+                      const histogram_snapshot&,
+                      double scale);
+
+    private:
+      typedef std::map<std::string, statement_stats*> statement_map;
+      typedef std::map<sqlite3*, connection_state*> connection_map;
+
+      mutable details::mutex mutex_;
+      statement_map statements_;
+      connection_map connections_;
+    };
+  }
+}
+
+#include <odb/sqlite/metrics-tracer.ixx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_METRICS_TRACER_HXX
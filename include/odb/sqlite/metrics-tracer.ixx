@@ -0,0 +1,512 @@
+// file      : odb/sqlite/metrics-tracer.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <cstdio>  // std::rename
+#include <ostream>
+#include <fstream>
+
+#include <odb/details/lock.hxx>
+
+#include <odb/sqlite/statement.hxx>
+#include <odb/sqlite/connection.hxx>
+
+#ifdef ODB_CXX11
+#  include <chrono>
+#elif defined(ODB_THREADS_POSIX)
+#  include <sys/time.h> // gettimeofday
+#endif
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // histogram_snapshot
+    //
+
+    inline unsigned long long histogram_snapshot::
+    percentile (double p) const
+    {
+      if (count == 0)
+        return 0;
+
+      // Rank of the value we are looking for, 1-based.
+      //
+      double r (p / 100 * static_cast<double> (count));
+      std::size_t n (0);
+
+      for (std::vector<bucket>::const_iterator i (buckets.begin ());
+           i != buckets.end (); ++i)
+      {
+        n += i->count;
+
+        if (static_cast<double> (n) >= r)
+          return i->upper;
+      }
+
+      return buckets.back ().upper;
+    }
+
+    //
+    // metrics_histogram
+    //
+
+    inline metrics_histogram::
+    metrics_histogram ()
+        : count_ (0), sum_ (0)
+    {
+      for (std::size_t i (0); i != bucket_count; ++i)
+        buckets_[i] = 0;
+    }
+
+    inline std::size_t metrics_histogram::
+    index (unsigned long long v)
+    {
+      if (v < 4)
+        return static_cast<std::size_t> (v);
+
+      // Position of the most significant bit (2 or greater here).
+      //
+      std::size_t e (0);
+      for (unsigned long long x (v); x >>= 1;)
+        ++e;
+
+      return ((e - 1) << 2) + static_cast<std::size_t> ((v >> (e - 2)) & 3);
+    }
+
+    inline unsigned long long metrics_histogram::
+    lower_bound (std::size_t i)
+    {
+      if (i < 4)
+        return i;
+
+      std::size_t e ((i >> 2) + 1);
+      return static_cast<unsigned long long> (4 + (i & 3)) << (e - 2);
+    }
+
+    inline unsigned long long metrics_histogram::
+    upper_bound (std::size_t i)
+    {
+      return i + 1 < bucket_count
+        ? lower_bound (i + 1) - 1
+        : ~static_cast<unsigned long long> (0);
+    }
+
+    inline void metrics_histogram::
+    record (unsigned long long v)
+    {
+      details::atomic_add (buckets_[index (v)], 1);
+      details::atomic_add (count_, 1);
+      details::atomic_add (sum_, static_cast<std::size_t> (v));
+    }
+
+    inline histogram_snapshot metrics_histogram::
+    snapshot () const
+    {
+      histogram_snapshot r;
+
+      // The buckets are read one at a time so the total may be slightly
+      // off if values are being recorded concurrently. Derive the count
+      // from the buckets to keep the snapshot self-consistent.
+      //
+      for (std::size_t i (0); i != bucket_count; ++i)
+      {
+        std::size_t n (details::atomic_load (buckets_[i]));
+
+        if (n != 0)
+        {
+          histogram_snapshot::bucket b;
+          b.upper = upper_bound (i);
+          b.count = n;
+          r.buckets.push_back (b);
+          r.count += n;
+        }
+      }
+
+      r.sum = details::atomic_load (sum_);
+      return r;
+    }
+
+    //
+    // metrics_tracer
+    //
+
+    inline metrics_tracer::
+    ~metrics_tracer ()
+    {
+      for (connection_map::iterator i (connections_.begin ());
+           i != connections_.end (); ++i)
+        delete i->second;
+
+      for (statement_map::iterator i (statements_.begin ());
+           i != statements_.end (); ++i)
+        delete i->second;
+    }
+
+    inline void metrics_tracer::
+    prepare (connection& c, const statement& s)
+    {
+      std::string text (s.text ());
+
+      details::lock l (mutex_);
+
+      statement_map::iterator i (statements_.find (text));
+
+      if (i == statements_.end ())
+      {
+        statement_stats* st (new statement_stats (text));
+
+        try
+        {
+          i = statements_.insert (
+            statement_map::value_type (text, st)).first;
+        }
+        catch (...)
+        {
+          delete st;
+          throw;
+        }
+      }
+
+      details::atomic_add (i->second->prepares, 1);
+
+      connection_map::iterator j (connections_.find (c.handle ()));
+
+      if (j == connections_.end ())
+      {
+        connection_state* cs (new connection_state);
+
+        try
+        {
+          j = connections_.insert (
+            connection_map::value_type (c.handle (), cs)).first;
+        }
+        catch (...)
+        {
+          delete cs;
+          throw;
+        }
+      }
+
+      j->second->statements[s.handle ()] = i->second;
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+      // The handle may have been reused by a new connection so always
+      // (re)install the callback.
+      //
+      sqlite3_trace_v2 (c.handle (),
+                        SQLITE_TRACE_STMT |
+                        SQLITE_TRACE_ROW |
+                        SQLITE_TRACE_PROFILE,
+                        &trace,
+                        j->second);
+#endif
+    }
+
+    inline void metrics_tracer::
+    execute (connection&, const statement&)
+    {
+    }
+
+    inline void metrics_tracer::
+    execute (connection&, const char*)
+    {
+    }
+
+    inline void metrics_tracer::
+    deallocate (connection& c, const statement& s)
+    {
+      details::lock l (mutex_);
+
+      connection_map::iterator i (connections_.find (c.handle ()));
+
+      if (i != connections_.end ())
+      {
+        connection_state& cs (*i->second);
+        cs.statements.erase (s.handle ());
+
+        for (std::vector<run>::iterator j (cs.runs.begin ());
+             j != cs.runs.end (); ++j)
+        {
+          if (j->stmt == s.handle ())
+          {
+            cs.runs.erase (j);
+            break;
+          }
+        }
+      }
+    }
+
+#if SQLITE_VERSION_NUMBER >= 3014000
+    inline int metrics_tracer::
+    trace (unsigned int type, void* state, void* p, void* x)
+    {
+      connection_state& cs (*static_cast<connection_state*> (state));
+      sqlite3_stmt* stmt (static_cast<sqlite3_stmt*> (p));
+
+      std::vector<run>::iterator i (cs.runs.begin ());
+      for (; i != cs.runs.end () && i->stmt != stmt; ++i) ;
+
+      switch (type)
+      {
+      case SQLITE_TRACE_STMT:
+        {
+          if (i != cs.runs.end ())
+          {
+            i->start = now ();
+            i->rows = 0;
+            break;
+          }
+
+          connection_state::statement_map::iterator j (
+            cs.statements.find (stmt));
+
+          // Statements that were not prepared by ODB are not tracked.
+          //
+          if (j != cs.statements.end ())
+          {
+            run r;
+            r.stmt = stmt;
+            r.stats = j->second;
+            r.start = now ();
+            r.rows = 0;
+            cs.runs.push_back (r);
+          }
+
+          break;
+        }
+      case SQLITE_TRACE_ROW:
+        {
+          if (i != cs.runs.end ())
+          {
+            if (i->rows++ == 0)
+              i->stats->first_step.record (now () - i->start);
+          }
+
+          break;
+        }
+      case SQLITE_TRACE_PROFILE:
+        {
+          if (i != cs.runs.end ())
+          {
+            // Elapsed time is in nanoseconds.
+            //
+            complete (*i, static_cast<unsigned long long> (
+                        *static_cast<sqlite3_int64*> (x)) / 1000);
+            cs.runs.erase (i);
+          }
+
+          break;
+        }
+      }
+
+      return 0;
+    }
+
+    inline void metrics_tracer::
+    complete (run& r, unsigned long long elapsed)
+    {
+      statement_stats& s (*r.stats);
+
+      if (r.rows == 0)
+        s.first_step.record (elapsed);
+
+      s.total.record (elapsed);
+      s.rows.record (r.rows);
+
+      details::atomic_add (
+        s.full_scan_steps,
+        static_cast<std::size_t> (
+          sqlite3_stmt_status (r.stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1)));
+
+      details::atomic_add (
+        s.sorts,
+        static_cast<std::size_t> (
+          sqlite3_stmt_status (r.stmt, SQLITE_STMTSTATUS_SORT, 1)));
+
+      details::atomic_add (
+        s.auto_indexes,
+        static_cast<std::size_t> (
+          sqlite3_stmt_status (r.stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1)));
+
+      details::atomic_add (
+        s.vm_steps,
+        static_cast<std::size_t> (
+          sqlite3_stmt_status (r.stmt, SQLITE_STMTSTATUS_VM_STEP, 1)));
+    }
+#endif
+
+    inline unsigned long long metrics_tracer::
+    now ()
+    {
+#ifdef ODB_CXX11
+      using namespace std::chrono;
+
+      return static_cast<unsigned long long> (
+        duration_cast<microseconds> (
+          steady_clock::now ().time_since_epoch ()).count ());
+#elif defined(ODB_THREADS_POSIX)
+      timeval tv;
+      gettimeofday (&tv, 0);
+      return static_cast<unsigned long long> (tv.tv_sec) * 1000000 +
+        static_cast<unsigned long long> (tv.tv_usec);
+#else
+      return 0;
+#endif
+    }
+
+    inline std::vector<statement_metrics> metrics_tracer::
+    snapshot () const
+    {
+      std::vector<statement_metrics> r;
+
+      details::lock l (mutex_);
+      r.reserve (statements_.size ());
+
+      for (statement_map::const_iterator i (statements_.begin ());
+           i != statements_.end (); ++i)
+      {
+        statement_stats& s (*i->second);
+
+        statement_metrics m;
+        m.text = s.text;
+        m.prepares = details::atomic_load (s.prepares);
+        m.first_step = s.first_step.snapshot ();
+        m.total = s.total.snapshot ();
+        m.rows = s.rows.snapshot ();
+        m.full_scan_steps = details::atomic_load (s.full_scan_steps);
+        m.sorts = details::atomic_load (s.sorts);
+        m.auto_indexes = details::atomic_load (s.auto_indexes);
+        m.vm_steps = details::atomic_load (s.vm_steps);
+        r.push_back (m);
+      }
+
+      return r;
+    }
+
+    inline void metrics_tracer::
+    dump_histogram (std::ostream& os,
+                    const char* name,
+                    const std::string& labels,
+                    const histogram_snapshot& h,
+                    double scale)
+    {
+      std::size_t n (0);
+
+      for (std::vector<histogram_snapshot::bucket>::const_iterator i (
+             h.buckets.begin ()); i != h.buckets.end (); ++i)
+      {
+        n += i->count;
+        os << name << "_bucket{" << labels << ",le=\""
+           << static_cast<double> (i->upper) * scale << "\"} " << n << '\n';
+      }
+
+      os << name << "_bucket{" << labels << ",le=\"+Inf\"} " << h.count
+         << '\n'
+         << name << "_sum{" << labels << "} "
+         << static_cast<double> (h.sum) * scale << '\n'
+         << name << "_count{" << labels << "} " << h.count << '\n';
+    }
+
+    inline void metrics_tracer::
+    dump (std::ostream& os) const
+    {
+      std::vector<statement_metrics> ms (snapshot ());
+
+      // Escape the statement texts as label values.
+      //
+      std::vector<std::string> ls;
+      ls.reserve (ms.size ());
+
+      for (std::vector<statement_metrics>::const_iterator i (ms.begin ());
+           i != ms.end (); ++i)
+      {
+        std::string l ("statement=\"");
+        for (std::string::const_iterator j (i->text.begin ());
+             j != i->text.end (); ++j)
+        {
+          switch (*j)
+          {
+          case '\\': l += "\\\\"; break;
+          case '"':  l += "\\\""; break;
+          case '\n': l += "\\n"; break;
+          default:   l += *j; break;
+          }
+        }
+        l += '"';
+        ls.push_back (l);
+      }
+
+      // Each metric family has to be written as one group of samples
+      // that follows its TYPE line.
+      //
+      struct counter
+      {
+        const char* name;
+        std::size_t statement_metrics::*value;
+      };
+
+      struct histogram
+      {
+        const char* name;
+        histogram_snapshot statement_metrics::*value;
+        double scale;
+      };
+
+      static const counter counters[] = {
+        {"odb_statement_prepares_total", &statement_metrics::prepares},
+        {"odb_statement_full_scan_steps_total",
+         &statement_metrics::full_scan_steps},
+        {"odb_statement_sorts_total", &statement_metrics::sorts},
+        {"odb_statement_auto_indexes_total",
+         &statement_metrics::auto_indexes},
+        {"odb_statement_vm_steps_total", &statement_metrics::vm_steps}};
+
+      static const histogram histograms[] = {
+        {"odb_statement_first_step_seconds",
+         &statement_metrics::first_step, 1e-6},
+        {"odb_statement_duration_seconds", &statement_metrics::total, 1e-6},
+        {"odb_statement_rows", &statement_metrics::rows, 1}};
+
+      for (std::size_t k (0); k != sizeof (counters) / sizeof (counter); ++k)
+      {
+        const counter& c (counters[k]);
+
+        os << "# TYPE " << c.name << " counter\n";
+
+        for (std::size_t i (0); i != ms.size (); ++i)
+          os << c.name << '{' << ls[i] << "} " << ms[i].*c.value << '\n';
+      }
+
+      for (std::size_t k (0);
+           k != sizeof (histograms) / sizeof (histogram);
+           ++k)
+      {
+        const histogram& h (histograms[k]);
+
+        os << "# TYPE " << h.name << " histogram\n";
+
+        for (std::size_t i (0); i != ms.size (); ++i)
+          dump_histogram (os, h.name, ls[i], ms[i].*h.value, h.scale);
+      }
+    }
+
+    inline void metrics_tracer::
+    dump (const std::string& path) const
+    {
+      std::string tmp (path + ".tmp");
+
+      {
+        std::ofstream ofs;
+        ofs.exceptions (std::ofstream::badbit | std::ofstream::failbit);
+        ofs.open (tmp.c_str ());
+        dump (ofs);
+        ofs.close ();
+      }
+
+      if (std::rename (tmp.c_str (), path.c_str ()) != 0)
+        throw std::ios_base::failure ("unable to rename " + tmp);
+    }
+  }
+}
@@ -0,0 +1,178 @@
+// file      : odb/sqlite/partial-update.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_PARTIAL_UPDATE_HXX
+#define ODB_SQLITE_PARTIAL_UPDATE_HXX
+
+#include <odb/pre.hxx>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/forward.hxx> // transaction
+
+#include <odb/details/tls.hxx>
+#include <odb/details/unique-ptr.hxx>
+#include <odb/details/shared-ptr.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/binding.hxx>
+#include <odb/sqlite/statement.hxx>
+#include <odb/sqlite/sqlite-types.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Partial UPDATE support for objects of one type on a connection. For
+    // each tracked object (identified by its id) we keep a snapshot of
+    // the update column values as they were last loaded or stored. When
+    // such an object is updated, only the columns that differ from the
+    // snapshot are written with a narrower UPDATE statement that is
+    // derived from the generated one and cached per column set.
+    //
+    // An object stops being tracked when its update is executed and is
+    // tracked again with the new state once the update is confirmed to
+    // have succeeded. All the snapshots are discarded if a transaction
+    // in which an update was confirmed is rolled back. In both cases
+    // subsequent updates of such objects write all the columns.
+    //
+    class partial_update
+    {
+    public:
+      // The update statement text is the generated "UPDATE ... SET ...
+      // WHERE ..." statement with one parameter for each of the update
+      // columns followed by the id and optimistic concurrency (suffix)
+      // parameters.
+      //
+      partial_update (connection&,
+                      const char* update_text,
+                      std::size_t update_columns,
+                      std::size_t id_columns,
+                      std::size_t suffix_columns);
+
+      ~partial_update ();
+
+      bool
+      empty () const
+      {
+        return snapshots_.empty ();
+      }
+
+      // Record the values of the update columns as the state of the
+      // object with the specified id.
+      //
+      void
+      track (const bind* columns, const bind* id);
+
+      void
+      untrack (const bind* id);
+
+      void
+      clear ();
+
+      // Return the statement for updating the object whose update
+      // columns and suffix are bound to the specified array or NULL if
+      // the object is not tracked. The statement is bound to a copy of
+      // the relevant subset of the array.
+      //
+      update_statement*
+      statement (const bind*);
+
+      // Forget the update started by the last call to statement(). Called
+      // before each update since the previous one may have failed.
+      //
+      void
+      cancel ();
+
+      // Indicate that the update executed with the statement returned
+      // by the last call to statement() has succeeded.
+      //
+      void
+      confirm ();
+
+      // The partial update whose object is being updated in the current
+      // thread, if any. Reset it before calling the generated update
+      // function and confirm it once it returns.
+      //
+      static void
+      reset_pending ();
+
+      static void
+      confirm_pending ();
+
+    private:
+      partial_update (const partial_update&);
+      partial_update& operator= (const partial_update&);
+
+    private:
+      typedef std::vector<std::string> values;
+
+      static void
+      serialize (std::string&, const bind&);
+
+      void
+      key (std::string&, const bind* id) const;
+
+      void
+      arm ();
+
+      static void
+      rollback (unsigned short, void* key, unsigned long long);
+
+      template <typename X>
+      struct pending_update
+      {
+        static ODB_TLS_POINTER (partial_update) value;
+      };
+
+    private:
+      struct entry
+      {
+        std::vector<bind> binds;
+        binding param;
+        details::shared_ptr<update_statement> statement;
+      };
+
+      typedef std::map<std::string, values> snapshot_map;
+      typedef std::map<std::string, entry*> statement_map;
+
+      // Maximum number of cached column-set statements.
+      //
+      static const std::size_t max_statements = 64;
+
+      connection& conn_;
+      std::size_t columns_;
+      std::size_t id_columns_;
+      std::size_t suffix_columns_;
+
+      // Parsed update statement. If the text has an unexpected form, then
+      // valid_ is false and objects are always updated in full.
+      //
+      bool valid_;
+      std::string head_;             // UPDATE ... SET
+      std::vector<std::string> set_; // Parameter assignments.
+      std::string fixed_;            // Assignments without parameters.
+      std::string tail_;             // WHERE ...
+
+      snapshot_map snapshots_;
+      statement_map statements_;
+
+      bool pending_;
+      std::string pending_key_;
+      values pending_values_;
+
+      odb::transaction* tran_;
+    };
+  }
+}
+
+#include <odb/sqlite/partial-update.ixx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_PARTIAL_UPDATE_HXX
@@ -0,0 +1,392 @@
+// file      : odb/sqlite/partial-update.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/transaction.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename X>
+    ODB_TLS_POINTER (partial_update) partial_update::pending_update<X>::
+    value;
+
+    inline partial_update::
+    partial_update (connection& c,
+                    const char* text,
+                    std::size_t columns,
+                    std::size_t id_columns,
+                    std::size_t suffix_columns)
+        : conn_ (c),
+          columns_ (columns),
+          id_columns_ (id_columns),
+          suffix_columns_ (suffix_columns),
+          valid_ (false),
+          pending_ (false),
+          tran_ (0)
+    {
+      // Split the statement into the UPDATE ... SET head, the list of
+      // assignments, and the WHERE ... tail. Ignore anything that is
+      // quoted.
+      //
+      std::string s (text);
+      std::string::size_type set (std::string::npos);
+      std::string::size_type where (std::string::npos);
+      std::vector<std::string> as;
+
+      std::string::size_type b (0);
+      char q ('\0');
+
+      for (std::string::size_type i (0), n (s.size ()); i != n; ++i)
+      {
+        char c (s[i]);
+
+        if (q != '\0')
+        {
+          if (c == q)
+            q = '\0';
+        }
+        else if (c == '"' || c == '\'' || c == '`' || c == '[')
+          q = (c == '[' ? ']' : c);
+        else if (set == std::string::npos)
+        {
+          if (s.compare (i, 5, " SET ") == 0)
+          {
+            set = i;
+            b = i + 5;
+            i += 4;
+          }
+        }
+        else if (where == std::string::npos)
+        {
+          if (c == ',')
+          {
+            as.push_back (s.substr (b, i - b));
+            b = i + 1;
+
+            while (b != n && s[b] == ' ')
+              b++;
+          }
+          else if (s.compare (i, 7, " WHERE ") == 0)
+          {
+            as.push_back (s.substr (b, i - b));
+            where = i;
+            i += 6;
+          }
+        }
+      }
+
+      if (set == std::string::npos || where == std::string::npos)
+        return;
+
+      for (std::vector<std::string>::iterator i (as.begin ());
+           i != as.end ();
+           ++i)
+      {
+        const std::string& a (*i);
+
+        if (a.size () > 2 && a.compare (a.size () - 2, 2, "=?") == 0)
+          set_.push_back (a);
+        else
+        {
+          if (!fixed_.empty ())
+            fixed_ += ", ";
+
+          fixed_ += a;
+        }
+      }
+
+      head_.assign (s, 0, set + 4);
+      tail_.assign (s, where + 1, std::string::npos);
+
+      std::size_t params (0);
+      for (std::string::size_type i (0); i != tail_.size (); ++i)
+        if (tail_[i] == '?')
+          params++;
+
+      valid_ = set_.size () == columns_ &&
+        params == suffix_columns_ &&
+        id_columns_ <= suffix_columns_ &&
+        columns_ != 0;
+    }
+
+    inline partial_update::
+    ~partial_update ()
+    {
+      if (tran_ != 0)
+        tran_->callback_unregister (this);
+
+      if (details::tls_get (pending_update<void>::value) == this)
+        reset_pending ();
+
+      for (statement_map::iterator i (statements_.begin ());
+           i != statements_.end ();
+           ++i)
+        delete i->second;
+    }
+
+    inline void partial_update::
+    serialize (std::string& r, const bind& b)
+    {
+      if (b.is_null != 0 && *b.is_null)
+      {
+        r += 'n';
+        return;
+      }
+
+      r += static_cast<char> ('0' + b.type);
+
+      switch (b.type)
+      {
+      case bind::integer:
+        {
+          r.append (static_cast<const char*> (b.buffer), sizeof (long long));
+          break;
+        }
+      case bind::real:
+        {
+          r.append (static_cast<const char*> (b.buffer), sizeof (double));
+          break;
+        }
+      case bind::text:
+      case bind::text16:
+      case bind::blob:
+        {
+          r.append (static_cast<const char*> (b.buffer), *b.size);
+          break;
+        }
+      }
+    }
+
+    inline void partial_update::
+    key (std::string& r, const bind* id) const
+    {
+      for (std::size_t i (0); i != id_columns_; ++i)
+      {
+        std::string v;
+        serialize (v, id[i]);
+
+        std::size_t n (v.size ());
+        r.append (reinterpret_cast<const char*> (&n), sizeof (n));
+        r += v;
+      }
+    }
+
+    inline void partial_update::
+    track (const bind* columns, const bind* id)
+    {
+      if (!valid_)
+        return;
+
+      std::string k;
+      key (k, id);
+
+      values& v (snapshots_[k]);
+      v.resize (columns_);
+
+      for (std::size_t i (0); i != columns_; ++i)
+      {
+        v[i].clear ();
+        serialize (v[i], columns[i]);
+      }
+    }
+
+    inline void partial_update::
+    untrack (const bind* id)
+    {
+      if (snapshots_.empty ())
+        return;
+
+      std::string k;
+      key (k, id);
+      snapshots_.erase (k);
+    }
+
+    inline void partial_update::
+    clear ()
+    {
+      snapshots_.clear ();
+      pending_ = false;
+    }
+
+    inline update_statement* partial_update::
+    statement (const bind* b)
+    {
+      pending_ = false;
+
+      if (!valid_)
+        return 0;
+
+      const bind* suffix (b + columns_);
+
+      pending_key_.clear ();
+      key (pending_key_, suffix);
+
+      snapshot_map::iterator si (snapshots_.find (pending_key_));
+
+      if (si == snapshots_.end ())
+        return 0;
+
+      const values& old (si->second);
+
+      pending_values_.resize (columns_);
+
+      std::string mask (columns_, '0');
+      std::size_t n (0);
+
+      for (std::size_t i (0); i != columns_; ++i)
+      {
+        std::string& v (pending_values_[i]);
+        v.clear ();
+        serialize (v, b[i]);
+
+        if (v != old[i])
+        {
+          mask[i] = '1';
+          n++;
+        }
+      }
+
+      // Until the update is confirmed, we don't know what's in the
+      // database so stop tracking the object for now.
+      //
+      snapshots_.erase (si);
+      pending_ = true;
+      details::tls_set (pending_update<void>::value, this);
+
+      // If everything has changed, then the full statement is as good as
+      // ours.
+      //
+      if (n == columns_)
+        return 0;
+
+      // We still need to execute something to detect a missing object or
+      // a concurrent modification.
+      //
+      if (n == 0 && fixed_.empty ())
+      {
+        mask[0] = '1';
+        n = 1;
+      }
+
+      statement_map::iterator i (statements_.find (mask));
+
+      if (i == statements_.end ())
+      {
+        if (statements_.size () >= max_statements)
+        {
+          for (i = statements_.begin (); i != statements_.end (); ++i)
+            delete i->second;
+
+          statements_.clear ();
+        }
+
+        std::string text (head_);
+        bool first (true);
+
+        for (std::size_t j (0); j != columns_; ++j)
+        {
+          if (mask[j] == '1')
+          {
+            text += first ? " " : ", ";
+            text += set_[j];
+            first = false;
+          }
+        }
+
+        if (!fixed_.empty ())
+        {
+          text += first ? " " : ", ";
+          text += fixed_;
+        }
+
+        text += ' ';
+        text += tail_;
+
+        details::unique_ptr<entry> e (new entry);
+        e->binds.resize (n + suffix_columns_);
+        e->param.bind = &e->binds[0];
+        e->param.count = e->binds.size ();
+        e->statement.reset (
+          new (details::shared) update_statement (conn_, text, e->param));
+
+        i = statements_.insert (
+          statement_map::value_type (mask, e.get ())).first;
+        e.release ();
+      }
+
+      entry& e (*i->second);
+
+      std::size_t k (0);
+
+      for (std::size_t j (0); j != columns_; ++j)
+      {
+        if (mask[j] == '1')
+          e.binds[k++] = b[j];
+      }
+
+      for (std::size_t j (0); j != suffix_columns_; ++j)
+        e.binds[k++] = suffix[j];
+
+      e.param.version++;
+      return e.statement.get ();
+    }
+
+    inline void partial_update::
+    cancel ()
+    {
+      pending_ = false;
+    }
+
+    inline void partial_update::
+    confirm ()
+    {
+      if (!pending_)
+        return;
+
+      pending_ = false;
+      snapshots_[pending_key_].swap (pending_values_);
+
+      if (tran_ == 0 && odb::transaction::has_current ())
+        arm ();
+    }
+
+    inline void partial_update::
+    arm ()
+    {
+      tran_ = &odb::transaction::current ();
+      tran_->callback_register (&rollback,
+                                this,
+                                odb::transaction::event_rollback,
+                                0,
+                                &tran_);
+    }
+
+    inline void partial_update::
+    rollback (unsigned short, void* key, unsigned long long)
+    {
+      // The database state that the snapshots describe is gone.
+      //
+      partial_update& p (*static_cast<partial_update*> (key));
+      p.clear ();
+    }
+
+    inline void partial_update::
+    reset_pending ()
+    {
+      details::tls_set (pending_update<void>::value,
+                        static_cast<partial_update*> (0));
+    }
+
+    inline void partial_update::
+    confirm_pending ()
+    {
+      if (partial_update* p = details::tls_get (pending_update<void>::value))
+      {
+        reset_pending ();
+        p->confirm ();
+      }
+    }
+  }
+}
@@ -0,0 +1,134 @@
+// file      : odb/sqlite/polymorphic-loader.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_POLYMORPHIC_LOADER_HXX
+#define ODB_SQLITE_POLYMORPHIC_LOADER_HXX
+
+#include <odb/pre.hxx>
+
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/traits.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/query.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Query loader for polymorphic objects. When a polymorphic query
+    // returns an object whose dynamic type is more derived than the
+    // query type, the derived part of the object is loaded with a
+    // separate SELECT for each such object. This loader avoids these
+    // per-object statements for the concrete types registered with
+    // add(). Objects of other types are loaded as usual. Two modes are
+    // supported:
+    //
+    // join      For each registered type, the query is executed against
+    //           that type (restricted to its discriminator) so that the
+    //           base and derived columns are fetched with one joined
+    //           statement. The remaining objects are loaded with the
+    //           query against T. The objects are grouped by type in the
+    //           result.
+    //
+    // deferred  The query against T is executed once. Objects of the
+    //           registered types are not loaded while iterating over
+    //           the result. Instead, their ids are collected and they
+    //           are loaded afterwards with batched database::find()
+    //           calls, one joined statement per type and chunk of ids.
+    //           The order of the objects is preserved.
+    //
+    // The query should be a condition without ORDER BY or similar
+    // clauses and the object pointer type should not be unique. The
+    // loader should be used within a transaction on the database. For
+    // example:
+    //
+    // sqlite::polymorphic_loader<animal> l (db);
+    // l.add<dog> ();
+    // l.add<cat> ();
+    //
+    // std::vector<animal*> v;
+    // l.load (query<animal>::age > 10, v);
+    //
+    template <typename T>
+    class polymorphic_loader
+    {
+    public:
+      typedef T object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+      typedef typename object_traits::id_type id_type;
+      typedef typename object_traits::pointer_type pointer_type;
+
+      typedef typename object_traits::root_type root_type;
+      typedef object_traits_impl<root_type, id_sqlite> root_traits;
+      typedef typename root_traits::discriminator_type discriminator_type;
+
+      typedef std::vector<pointer_type> pointers;
+
+      enum mode_type
+      {
+        join,
+        deferred
+      };
+
+      polymorphic_loader (database&, mode_type = join);
+
+      // Register a concrete type derived from T.
+      //
+      template <typename D>
+      void
+      add ();
+
+      // Append the objects matching the query to the vector.
+      //
+      void
+      load (const query_base&, pointers&);
+
+    private:
+      void
+      load_join (const query_base&, pointers&);
+
+      void
+      load_deferred (const query_base&, pointers&);
+
+      // Return the qualified discriminator column name or an empty string
+      // if it cannot be determined.
+      //
+      static std::string
+      discriminator_column ();
+
+      template <typename D>
+      static void
+      join_ (database&, const query_base&, pointers&);
+
+      template <typename D>
+      static void
+      find_ (database&, const std::vector<id_type>&, pointers&);
+
+    private:
+      struct entry
+      {
+        const discriminator_type* discriminator;
+        void (*join) (database&, const query_base&, pointers&);
+        void (*find) (database&, const std::vector<id_type>&, pointers&);
+      };
+
+      typedef std::vector<entry> entries;
+
+      database& db_;
+      mode_type mode_;
+      entries entries_;
+    };
+  }
+}
+
+#include <odb/sqlite/polymorphic-loader.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_POLYMORPHIC_LOADER_HXX
@@ -0,0 +1,203 @@
+// file      : odb/sqlite/polymorphic-loader.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/result.hxx>
+
+#include <odb/sqlite/database.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename T>
+    polymorphic_loader<T>::
+    polymorphic_loader (database& db, mode_type m)
+        : db_ (db), mode_ (m)
+    {
+    }
+
+    template <typename T>
+    template <typename D>
+    void polymorphic_loader<T>::
+    add ()
+    {
+      entry e;
+      e.discriminator = &object_traits_impl<D, id_sqlite>::info.discriminator;
+      e.join = &join_<D>;
+      e.find = &find_<D>;
+      entries_.push_back (e);
+    }
+
+    template <typename T>
+    void polymorphic_loader<T>::
+    load (const query_base& q, pointers& r)
+    {
+      if (mode_ == join && !entries_.empty ())
+        load_join (q, r);
+      else
+        load_deferred (q, r);
+    }
+
+    template <typename T>
+    void polymorphic_loader<T>::
+    load_join (const query_base& q, pointers& r)
+    {
+      std::string c (discriminator_column ());
+
+      if (c.empty ())
+      {
+        load_deferred (q, r);
+        return;
+      }
+
+      query_base rq (c);
+      rq += "NOT IN (";
+
+      for (typename entries::const_iterator i (entries_.begin ());
+           i != entries_.end (); ++i)
+      {
+        query_base dq (c);
+        dq += "=";
+        dq += query_base::_val (*i->discriminator);
+
+        i->join (db_, q.empty () ? dq : q && dq, r);
+
+        if (i != entries_.begin ())
+          rq += ",";
+
+        rq += query_base::_val (*i->discriminator);
+      }
+
+      rq += ")";
+
+      result<T> res (db_.query<T> (q.empty () ? rq : q && rq));
+
+      for (typename result<T>::iterator i (res.begin ());
+           i != res.end (); ++i)
+        r.push_back (i.load ());
+    }
+
+    template <typename T>
+    void polymorphic_loader<T>::
+    load_deferred (const query_base& q, pointers& r)
+    {
+      std::size_t n (entries_.size ());
+      std::size_t b (r.size ());
+
+      // For each object, the index of its type entry or n if its type is
+      // not registered (in which case the object is loaded right away).
+      //
+      std::vector<std::size_t> kinds;
+      std::vector<std::vector<id_type> > ids (n);
+
+      {
+        result<T> res (db_.query<T> (q));
+
+        for (typename result<T>::iterator i (res.begin ());
+             i != res.end (); ++i)
+        {
+          std::size_t k (n);
+
+          if (n != 0)
+          {
+            discriminator_type d (i.discriminator ());
+
+            for (k = 0; k != n; ++k)
+              if (*entries_[k].discriminator == d)
+                break;
+          }
+
+          if (k != n)
+          {
+            ids[k].push_back (i.id ());
+            r.push_back (pointer_type ());
+          }
+          else
+            r.push_back (i.load ());
+
+          kinds.push_back (k);
+        }
+      }
+
+      // Now that the result is gone, load the objects of the registered
+      // types and put them in their places.
+      //
+      for (std::size_t k (0); k != n; ++k)
+      {
+        if (ids[k].empty ())
+          continue;
+
+        pointers ps;
+        entries_[k].find (db_, ids[k], ps);
+
+        std::size_t j (0);
+        for (std::size_t i (0); i != kinds.size (); ++i)
+        {
+          if (kinds[i] == k)
+            r[b + i] = ps[j++];
+        }
+      }
+    }
+
+    template <typename T>
+    std::string polymorphic_loader<T>::
+    discriminator_column ()
+    {
+      // The discriminator is the first column in the root's discriminator
+      // find statement ("SELECT <column>, ... FROM ...").
+      //
+      std::string s (root_traits::find_discriminator_statement);
+
+      if (s.compare (0, 7, "SELECT ") != 0)
+        return std::string ();
+
+      std::string::size_type e (s.find (" FROM ", 7));
+      std::string::size_type p (s.find (',', 7));
+
+      if (p == std::string::npos || (e != std::string::npos && e < p))
+        p = e;
+
+      if (p == std::string::npos || p == 7)
+        return std::string ();
+
+      return std::string (s, 7, p - 7);
+    }
+
+    template <typename T>
+    template <typename D>
+    void polymorphic_loader<T>::
+    join_ (database& db, const query_base& q, pointers& r)
+    {
+      result<D> res (db.query<D> (q));
+
+      for (typename result<D>::iterator i (res.begin ());
+           i != res.end (); ++i)
+      {
+        pointer_type p (i.load ());
+        r.push_back (p);
+      }
+    }
+
+    template <typename T>
+    template <typename D>
+    void polymorphic_loader<T>::
+    find_ (database& db, const std::vector<id_type>& ids, pointers& r)
+    {
+      typedef typename object_traits_impl<D, id_sqlite>::pointer_type
+        derived_pointer_type;
+
+      std::vector<derived_pointer_type> ps (
+        db.find<D> (ids.begin (), ids.end ()));
+
+      r.reserve (r.size () + ps.size ());
+
+      for (typename std::vector<derived_pointer_type>::const_iterator i (
+             ps.begin ()); i != ps.end (); ++i)
+      {
+        pointer_type p (*i);
+        r.push_back (p);
+      }
+    }
+  }
+}
@@ -84,6 +84,11 @@ namespace odb
       details::shared_ptr<query_params> params_;
       details::shared_ptr<select_statement> statement_;
       statements_type& statements_;
+
+      // Concrete type of the last loaded object. Rows of the same type
+      // tend to come together so this saves most of the map lookups.
+      //
+      const typename root_traits::info_type* info_;
     };
   }
 }
@@ -44,7 +44,8 @@ namespace odb
         : base_type (sts.connection ()),
           params_ (q.parameters ()),
           statement_ (s),
-          statements_ (sts)
+          statements_ (sts),
+          info_ (0)
     {
     }
 
@@ -78,10 +79,13 @@ namespace odb
       // object_type is concrete and NULL if it is abstract.
       //
       const info_type* spi (polymorphic_info (object_traits::info));
-      const info_type& pi (
-        spi != 0 && spi->discriminator == d
-        ? *spi
-        : root_traits::map->find (d));
+
+      if (spi != 0 && spi->discriminator == d)
+        info_ = spi;
+      else if (info_ == 0 || !(info_->discriminator == d))
+        info_ = &root_traits::map->find (d);
+
+      const info_type& pi (*info_);
 
       typedef typename root_traits::pointer_type root_pointer_type;
       typedef typename root_traits::pointer_traits root_pointer_traits;
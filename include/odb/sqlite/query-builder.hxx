@@ -0,0 +1,420 @@
+// file      : odb/sqlite/query-builder.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_QUERY_BUILDER_HXX
+#define ODB_SQLITE_QUERY_BUILDER_HXX
+
+#include <odb/pre.hxx>
+
+#include <string>
+#include <cstddef> // std::size_t
+
+#include <odb/details/arena.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/query.hxx>
+#include <odb/sqlite/binding.hxx>
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/sqlite-types.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Text parameter that binds the string data directly instead of
+    // copying it into an image buffer.
+    //
+    class text_query_param: public query_param
+    {
+    public:
+      enum kind_type
+      {
+        kind_fixed,   // Data and size are set once.
+        kind_string,  // Value is std::string.
+        kind_array,   // Value is a NUL-terminated char array.
+        kind_pointer  // Value is a pointer to a NUL-terminated string.
+      };
+
+      text_query_param (const char* data, std::size_t size)
+          : query_param (0), kind_ (kind_fixed), data_ (data), size_ (size)
+      {
+      }
+
+      text_query_param (kind_type k, const void* value)
+          : query_param (value), kind_ (k), data_ (0), size_ (0)
+      {
+      }
+
+      virtual bool
+      init ();
+
+      virtual void
+      bind (sqlite::bind*);
+
+    private:
+      kind_type kind_;
+      const char* data_;
+      std::size_t size_;
+    };
+
+    // Query builder that avoids heap allocations for typical queries. It
+    // supports the same parts as query_base (columns, native SQL
+    // fragments, boolean literals, and by-value and by-reference
+    // parameters) but keeps them, together with the parameter objects,
+    // their bindings, and the resulting clause, in inline storage. Up to
+    // 16 parts and 16 parameters are kept without any heap allocations
+    // (some value types, such as std::wstring or BLOB types, still
+    // allocate their own image buffers).
+    //
+    // Columns and native fragments passed as const char* are not copied
+    // and should remain valid for the lifetime of the builder (which is
+    // the case for the column names in the generated query classes and
+    // for string literals). Native fragments passed as std::string and
+    // by-value text parameters are copied into the builder's arena.
+    //
+    // For example:
+    //
+    // typedef odb::query<person> query;
+    //
+    // sqlite::query_builder q;
+    // q += query::first;
+    // q += "=";
+    // q += query::_ref (first);
+    // q += "AND";
+    // q += query::age;
+    // q += ">";
+    // q += query::_val (30);
+    //
+    // An object query is executed with the database::query() overload
+    // for the builder:
+    //
+    // odb::result<person> r (db.query<person> (q));
+    //
+    // The result refers to the builder's parameters so the builder
+    // should outlive it. Converting the builder to query_base would
+    // bring back the allocations it is meant to avoid so there is no
+    // such conversion and the builder cannot be used to prepare a query.
+    // For repeatedly executed object queries, use prepared queries with
+    // by-reference parameters instead, which do not allocate once
+    // prepared.
+    //
+    // The builder also provides the interface that is used to execute a
+    // query on the statement level (clause(), clause_prefix(),
+    // init_parameters(), and parameters_binding()) and can be used, for
+    // example, with columnar_result or directly with select_statement.
+    //
+    class query_builder
+    {
+    public:
+      static const std::size_t inline_parts = 16;
+      static const std::size_t inline_params = 16;
+
+      query_builder ();
+      ~query_builder ();
+
+    public:
+      query_builder&
+      operator+= (const query_column_base& c)
+      {
+        append (c.table (), c.column (), c.conversion ());
+        return *this;
+      }
+
+      query_builder&
+      operator+= (const char* native)
+      {
+        append (native);
+        return *this;
+      }
+
+      query_builder&
+      operator+= (const std::string& native)
+      {
+        append (copy (native.c_str (), native.size ()), native.size ());
+        return *this;
+      }
+
+      query_builder&
+      operator+= (bool v)
+      {
+        append (v);
+        return *this;
+      }
+
+      template <typename T>
+      query_builder&
+      operator+= (val_bind<T> v)
+      {
+        append<T, type_traits<T>::db_type_id> (v);
+        return *this;
+      }
+
+      template <typename T, database_type_id ID>
+      query_builder&
+      operator+= (val_bind_typed<T, ID> v)
+      {
+        append<T, ID> (v);
+        return *this;
+      }
+
+      template <typename T>
+      query_builder&
+      operator+= (ref_bind<T> r)
+      {
+        append<T, type_traits<T>::db_type_id> (r);
+        return *this;
+      }
+
+      template <typename T, database_type_id ID>
+      query_builder&
+      operator+= (ref_bind_typed<T, ID> r)
+      {
+        append<T, ID> (r);
+        return *this;
+      }
+
+      // Statement-level interface, the same as in query_base.
+      //
+    public:
+      bool
+      empty () const
+      {
+        return parts_.empty ();
+      }
+
+      const char*
+      clause () const;
+
+      const char*
+      clause_prefix () const;
+
+      void
+      init_parameters () const;
+
+      binding&
+      parameters_binding () const
+      {
+        return binding_;
+      }
+
+      // Implementation details.
+      //
+    public:
+      void
+      append (const char* table, const char* column, const char* conv);
+
+      void
+      append (const char* native)
+      {
+        append (native, std::char_traits<char>::length (native));
+      }
+
+      void
+      append (const char* native, std::size_t size);
+
+      void
+      append (bool);
+
+      template <typename T, database_type_id ID>
+      void
+      append (val_bind<T>);
+
+      template <typename T, database_type_id ID>
+      void
+      append (ref_bind<T>);
+
+      // Add a parameter object allocated in the arena.
+      //
+      void
+      append (query_param*);
+
+      void*
+      allocate (std::size_t n)
+      {
+        return arena_.allocate (n);
+      }
+
+      const char*
+      copy (const char*, std::size_t);
+
+    private:
+      query_builder (const query_builder&);
+      query_builder& operator= (const query_builder&);
+
+      // Return true if the native clause starts with a keyword that
+      // makes the WHERE prefix unnecessary.
+      //
+      static bool
+      check_prefix (const char*, std::size_t);
+
+    private:
+      struct part
+      {
+        enum kind_type
+        {
+          kind_column,
+          kind_param,
+          kind_native,
+          kind_bool
+        };
+
+        kind_type kind;
+        const char* table;  // Column table or NULL.
+        const char* text;   // Column name, native SQL, or conversion.
+        std::size_t size;   // Native SQL length.
+        bool value;
+      };
+
+      typedef details::small_vector<part, inline_parts> parts;
+      typedef details::small_vector<query_param*, inline_params> params;
+      typedef details::small_vector<sqlite::bind, inline_params> binds;
+
+      details::arena<1024> arena_;
+
+      parts parts_;
+      params params_;
+      binds binds_;
+
+      // Conversion expression of the last column, applied to the
+      // parameter that follows it.
+      //
+      const char* conv_;
+
+      mutable binding binding_;
+      mutable const char* clause_;
+    };
+
+    // Creation of the parameter objects in the builder's arena.
+    //
+    template <typename T, database_type_id ID>
+    struct query_builder_param
+    {
+      typedef query_param_impl<T, ID> param_type;
+
+      static query_param*
+      create (query_builder& b, val_bind<T> v)
+      {
+        return ::new (b.allocate (sizeof (param_type))) param_type (v);
+      }
+
+      static query_param*
+      create (query_builder& b, ref_bind<T> r)
+      {
+        return ::new (b.allocate (sizeof (param_type))) param_type (r);
+      }
+    };
+
+    struct query_builder_text_param
+    {
+      static query_param*
+      create (query_builder& b, const char* s, std::size_t n)
+      {
+        return ::new (b.allocate (sizeof (text_query_param)))
+          text_query_param (b.copy (s, n), n);
+      }
+
+      static query_param*
+      create (query_builder& b,
+              text_query_param::kind_type k,
+              const void* value)
+      {
+        return ::new (b.allocate (sizeof (text_query_param)))
+          text_query_param (k, value);
+      }
+    };
+
+    template <>
+    struct query_builder_param<std::string, id_text>
+    {
+      static query_param*
+      create (query_builder& b, val_bind<std::string> v)
+      {
+        return query_builder_text_param::create (
+          b, v.val.c_str (), v.val.size ());
+      }
+
+      static query_param*
+      create (query_builder& b, ref_bind<std::string> r)
+      {
+        return query_builder_text_param::create (
+          b, text_query_param::kind_string, r.ptr ());
+      }
+    };
+
+    template <std::size_t N>
+    struct query_builder_param<char[N], id_text>
+    {
+      static query_param*
+      create (query_builder& b, val_bind<char[N]> v)
+      {
+        return query_builder_text_param::create (
+          b, v.val, std::char_traits<char>::length (v.val));
+      }
+
+      static query_param*
+      create (query_builder& b, ref_bind<char[N]> r)
+      {
+        return query_builder_text_param::create (
+          b, text_query_param::kind_array, r.ptr ());
+      }
+    };
+
+    template <>
+    struct query_builder_param<const char*, id_text>
+    {
+      static query_param*
+      create (query_builder& b, val_bind<const char*> v)
+      {
+        return query_builder_text_param::create (
+          b, v.val, std::char_traits<char>::length (v.val));
+      }
+
+      static query_param*
+      create (query_builder& b, ref_bind<const char*> r)
+      {
+        return query_builder_text_param::create (
+          b, text_query_param::kind_pointer, r.ptr ());
+      }
+    };
+
+    // Execution of object queries built with the builder. Polymorphic
+    // objects are not supported.
+    //
+    template <typename T, bool polymorphic = object_traits<T>::polymorphic>
+    struct query_builder_object;
+
+    template <typename T>
+    struct query_builder_object<T, false>
+    {
+      static result<T>
+      query (const query_builder&);
+    };
+
+    template <>
+    struct query_builder_param<char*, id_text>
+    {
+      static query_param*
+      create (query_builder& b, val_bind<char*> v)
+      {
+        return query_builder_text_param::create (
+          b, v.val, std::char_traits<char>::length (v.val));
+      }
+
+      static query_param*
+      create (query_builder& b, ref_bind<char*> r)
+      {
+        return query_builder_text_param::create (
+          b, text_query_param::kind_pointer, r.ptr ());
+      }
+    };
+  }
+}
+
+#include <odb/sqlite/query-builder.ixx>
+#include <odb/sqlite/query-builder.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_QUERY_BUILDER_HXX
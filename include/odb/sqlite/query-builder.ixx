@@ -0,0 +1,355 @@
+// file      : odb/sqlite/query-builder.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <cstring> // std::memcpy, std::memset, std::strlen, std::strstr
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // text_query_param
+    //
+
+    inline bool text_query_param::
+    init ()
+    {
+      const char* d;
+      std::size_t n;
+
+      switch (kind_)
+      {
+      case kind_string:
+        {
+          const std::string& s (*static_cast<const std::string*> (value_));
+          d = s.data ();
+          n = s.size ();
+          break;
+        }
+      case kind_array:
+        {
+          d = static_cast<const char*> (value_);
+          n = std::strlen (d);
+          break;
+        }
+      case kind_pointer:
+        {
+          d = *static_cast<const char* const*> (value_);
+          n = std::strlen (d);
+          break;
+        }
+      default:
+        return false;
+      }
+
+      // The size is bound by reference so we only need to rebind if the
+      // data has moved.
+      //
+      bool r (d != data_);
+      data_ = d;
+      size_ = n;
+      return r;
+    }
+
+    inline void text_query_param::
+    bind (sqlite::bind* b)
+    {
+      b->type = sqlite::bind::text;
+      b->buffer = const_cast<char*> (data_);
+      b->size = &size_;
+    }
+
+    //
+    // query_builder
+    //
+
+    inline query_builder::
+    query_builder ()
+        : conv_ (0), clause_ (0)
+    {
+    }
+
+    inline query_builder::
+    ~query_builder ()
+    {
+      // The parameters live in the arena so we only need to destroy them.
+      //
+      for (std::size_t i (0); i != params_.size (); ++i)
+        params_[i]->~query_param ();
+    }
+
+    inline const char* query_builder::
+    copy (const char* s, std::size_t n)
+    {
+      char* r (static_cast<char*> (arena_.allocate (n + 1)));
+      std::memcpy (r, s, n);
+      r[n] = '\0';
+      return r;
+    }
+
+    inline void query_builder::
+    append (const char* table, const char* column, const char* conv)
+    {
+      part p;
+      p.kind = part::kind_column;
+      p.table = table;
+      p.text = column;
+      p.size = 0;
+      p.value = false;
+      parts_.push_back (p);
+
+      conv_ = conv;
+      clause_ = 0;
+    }
+
+    inline void query_builder::
+    append (const char* native, std::size_t size)
+    {
+      part p;
+      p.kind = part::kind_native;
+      p.table = 0;
+      p.text = native;
+      p.size = size;
+      p.value = false;
+      parts_.push_back (p);
+
+      clause_ = 0;
+    }
+
+    inline void query_builder::
+    append (bool v)
+    {
+      part p;
+      p.kind = part::kind_bool;
+      p.table = 0;
+      p.text = 0;
+      p.size = 0;
+      p.value = v;
+      parts_.push_back (p);
+
+      clause_ = 0;
+    }
+
+    inline void query_builder::
+    append (query_param* qp)
+    {
+      try
+      {
+        params_.push_back (qp);
+      }
+      catch (...)
+      {
+        qp->~query_param ();
+        throw;
+      }
+
+      sqlite::bind b;
+      std::memset (&b, 0, sizeof (b));
+      binds_.push_back (b);
+
+      qp->bind (&binds_.back ());
+
+      // The bindings may have moved (for example, from the inline storage
+      // to the heap) so always update the pointer.
+      //
+      binding_.bind = binds_.data ();
+      binding_.count = binds_.size ();
+      binding_.version++;
+
+      part p;
+      p.kind = part::kind_param;
+      p.table = 0;
+      p.text = conv_;
+      p.size = 0;
+      p.value = false;
+      parts_.push_back (p);
+
+      conv_ = 0;
+      clause_ = 0;
+    }
+
+    inline void query_builder::
+    init_parameters () const
+    {
+      bool inc_ver (false);
+
+      for (std::size_t i (0); i != params_.size (); ++i)
+      {
+        query_param& p (*params_[i]);
+
+        if (p.reference () && p.init ())
+        {
+          p.bind (const_cast<sqlite::bind*> (&binds_[i]));
+          inc_ver = true;
+        }
+      }
+
+      if (inc_ver)
+        binding_.version++;
+    }
+
+    inline bool query_builder::
+    check_prefix (const char* s, std::size_t size)
+    {
+      static const char* const keywords[] = {
+        "WHERE", "where",
+        "SELECT", "select",
+        "ORDER BY", "order by",
+        "GROUP BY", "group by",
+        "HAVING", "having"};
+
+      for (std::size_t i (0); i != sizeof (keywords) / sizeof (char*); ++i)
+      {
+        std::size_t n (std::strlen (keywords[i]));
+
+        // It either has to be an exact match or there should be a
+        // whitespace following the keyword.
+        //
+        if (size >= n && std::memcmp (s, keywords[i], n) == 0 &&
+            (size == n || s[n] == ' ' || s[n] == '\t' || s[n] == '\n'))
+          return true;
+      }
+
+      return false;
+    }
+
+    inline const char* query_builder::
+    clause_prefix () const
+    {
+      if (!parts_.empty ())
+      {
+        const part& p (parts_[0]);
+
+        if (p.kind == part::kind_native && check_prefix (p.text, p.size))
+          return "";
+
+        return "WHERE ";
+      }
+
+      return "";
+    }
+
+    inline const char* query_builder::
+    clause () const
+    {
+      if (clause_ != 0)
+        return clause_;
+
+      // Calculate the upper bound for the clause length so that we can
+      // render it into a single arena allocation.
+      //
+      std::size_t n (1);
+
+      for (std::size_t i (0); i != parts_.size (); ++i)
+      {
+        const part& p (parts_[i]);
+
+        switch (p.kind)
+        {
+        case part::kind_column:
+          {
+            n += 2 + std::strlen (p.table) + std::strlen (p.text);
+            break;
+          }
+        case part::kind_param:
+          {
+            n += 2 + (p.text != 0 ? std::strlen (p.text) : 0);
+            break;
+          }
+        case part::kind_native:
+          {
+            n += 1 + p.size;
+            break;
+          }
+        case part::kind_bool:
+          {
+            n += 2;
+            break;
+          }
+        }
+      }
+
+      query_builder& self (const_cast<query_builder&> (*this));
+      char* r (static_cast<char*> (self.arena_.allocate (n)));
+      char* e (r);
+
+      for (std::size_t i (0); i != parts_.size (); ++i)
+      {
+        const part& p (parts_[i]);
+        char last (e != r ? e[-1] : ' ');
+
+        switch (p.kind)
+        {
+        case part::kind_column:
+          {
+            if (last != ' ' && last != '(')
+              *e++ = ' ';
+
+            std::size_t tn (std::strlen (p.table));
+            std::memcpy (e, p.table, tn);
+            e += tn;
+            *e++ = '.';
+
+            std::size_t cn (std::strlen (p.text));
+            std::memcpy (e, p.text, cn);
+            e += cn;
+            break;
+          }
+        case part::kind_param:
+          {
+            if (last != ' ' && last != '(')
+              *e++ = ' ';
+
+            // Add the conversion expression, if any.
+            //
+            const char* c (p.text != 0 ? std::strstr (p.text, "(?)") : 0);
+
+            if (c != 0)
+            {
+              std::size_t cn (static_cast<std::size_t> (c - p.text));
+              std::memcpy (e, p.text, cn);
+              e += cn;
+              *e++ = '?';
+
+              std::size_t sn (std::strlen (c + 3));
+              std::memcpy (e, c + 3, sn);
+              e += sn;
+            }
+            else
+              *e++ = '?';
+
+            break;
+          }
+        case part::kind_native:
+          {
+            // We don't want extra spaces after '(' as well as before ','
+            // and ')'.
+            //
+            char first (p.size != 0 ? p.text[0] : ' ');
+
+            if (last != ' ' && first != ' ' && last != '(' &&
+                first != ',' && first != ')')
+              *e++ = ' ';
+
+            std::memcpy (e, p.text, p.size);
+            e += p.size;
+            break;
+          }
+        case part::kind_bool:
+          {
+            if (last != ' ' && last != '(')
+              *e++ = ' ';
+
+            *e++ = p.value ? '1' : '0';
+            break;
+          }
+        }
+      }
+
+      *e = '\0';
+      clause_ = r;
+      return clause_;
+    }
+  }
+}
@@ -0,0 +1,90 @@
+// file      : odb/sqlite/query-builder.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/sqlite/statement.hxx>
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/transaction.hxx>
+#include <odb/sqlite/statement-cache.hxx>
+#include <odb/sqlite/simple-object-result.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename T, database_type_id ID>
+    void query_builder::
+    append (val_bind<T> v)
+    {
+      append (query_builder_param<T, ID>::create (*this, v));
+    }
+
+    template <typename T, database_type_id ID>
+    void query_builder::
+    append (ref_bind<T> r)
+    {
+      append (query_builder_param<T, ID>::create (*this, r));
+    }
+
+    template <typename T>
+    inline result<T> database::
+    query (const query_builder& q)
+    {
+      return query_builder_object<T>::query (q);
+    }
+
+    template <typename T>
+    result<T> query_builder_object<T, false>::
+    query (const query_builder& q)
+    {
+      using odb::details::shared;
+      using odb::details::shared_ptr;
+
+      typedef object_traits_impl<T, id_sqlite> object_traits;
+      typedef typename object_traits::statements_type statements_type;
+      typedef typename object_traits::image_type image_type;
+
+      // Throws if not in transaction.
+      //
+      connection& c (transaction::current ().connection ());
+
+      statements_type& sts (
+        c.statement_cache ().template find_object<T> ());
+
+      image_type& im (sts.image ());
+      binding& imb (sts.select_image_binding ());
+
+      if (im.version != sts.select_image_version () || imb.version == 0)
+      {
+        object_traits::bind (imb.bind, im, statement_select);
+        sts.select_image_version (im.version);
+        imb.version++;
+      }
+
+      std::string text (object_traits::query_statement);
+      if (!q.empty ())
+      {
+        text += ' ';
+        text += q.clause_prefix ();
+        text += q.clause ();
+      }
+
+      q.init_parameters ();
+
+      shared_ptr<select_statement> st (
+        new (shared) select_statement (
+          c, text, q.parameters_binding (), imb));
+
+      st->execute ();
+
+      // The parameters are owned by the builder rather than the query
+      // that the result would normally hold on to.
+      //
+      shared_ptr<odb::object_result_impl<T> > r (
+        new (shared) sqlite::object_result_impl<T> (
+          sqlite::query_base (), st, sts));
+
+      return result<T> (r);
+    }
+  }
+}
@@ -0,0 +1,191 @@
+// file      : odb/sqlite/query-cache.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_QUERY_CACHE_HXX
+#define ODB_SQLITE_QUERY_CACHE_HXX
+
+#include <odb/pre.hxx>
+
+#include <map>
+#include <list>
+#include <string>
+#include <vector>
+#include <cstddef> // std::size_t
+
+#include <odb/result.hxx>
+#include <odb/query-dynamic.hxx>
+
+#include <odb/details/shared-ptr.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/query.hxx>
+#include <odb/sqlite/binding.hxx>
+#include <odb/sqlite/statement.hxx>
+#include <odb/sqlite/query-dynamic.hxx>
+#include <odb/sqlite/simple-object-result.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Cache of translated dynamic (odb::query_base) object queries. The
+    // cache is keyed by the structure of the query clause, that is, the
+    // columns, operators, and native fragments but not the parameter
+    // values. On a hit, the SQL text translation and statement
+    // preparation are skipped, and only the parameter values are bound
+    // to the cached statement.
+    //
+    // Since prepared statements belong to a connection, the cache is
+    // per-connection and the queries should be executed in a transaction
+    // on this connection. The results returned by query() hold on to
+    // their statements and parameters and may outlive the cache. Only
+    // simple (non-polymorphic) object queries are supported. For example:
+    //
+    // sqlite::dynamic_query_cache qc (conn, 64);
+    //
+    // transaction t (conn.begin ());
+    // odb::result<person> r (qc.query<person> (q));
+    //
+    class dynamic_query_cache
+    {
+    public:
+      struct statistics_type
+      {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t evictions;
+        std::size_t size;
+      };
+
+      // The max_size argument specifies the maximum number of cached
+      // statements. Entries with active results are never evicted so the
+      // cache may temporarily exceed this size.
+      //
+      dynamic_query_cache (connection&, std::size_t max_size = 128);
+
+      ~dynamic_query_cache ();
+
+      template <typename T>
+      result<T>
+      query (const odb::query_base&);
+
+      statistics_type
+      statistics () const;
+
+      void
+      clear ();
+
+    private:
+      dynamic_query_cache (const dynamic_query_cache&);
+      dynamic_query_cache& operator= (const dynamic_query_cache&);
+
+    private:
+      // Parameters bound to the statement. Recreated from the dynamic
+      // query on each execution. Shared with the result since SQLite uses
+      // the parameter buffers to find each next row.
+      //
+      struct parameters: details::shared_base
+      {
+        std::vector<details::shared_ptr<query_param> > params;
+        std::vector<sqlite::bind> binds;
+        binding param_binding;
+      };
+
+      struct entry
+      {
+        std::size_t hash;
+        std::string signature;
+
+        details::shared_ptr<select_statement> statement;
+        details::shared_ptr<parameters> params;
+      };
+
+      // The parameters are a base so that they are destroyed after the
+      // result has released the statement.
+      //
+      struct parameters_holder
+      {
+        parameters_holder (const details::shared_ptr<parameters>& p)
+            : params_ (p) {}
+
+        details::shared_ptr<parameters> params_;
+      };
+
+      template <typename T>
+      class cached_result: parameters_holder,
+                           public sqlite::object_result_impl<T>
+      {
+      public:
+        typedef typename sqlite::object_result_impl<T>::statements_type
+        statements_type;
+
+        cached_result (const details::shared_ptr<parameters>& p,
+                       const details::shared_ptr<select_statement>& st,
+                       statements_type& sts)
+            : parameters_holder (p),
+              sqlite::object_result_impl<T> (sqlite::query_base (), st, sts)
+        {
+        }
+      };
+
+      typedef std::list<entry*> entry_list;
+      typedef std::multimap<std::size_t, entry_list::iterator> entry_map;
+
+      // Append the structure of the query clause to the signature. The
+      // prefix distinguishes queries for different object types.
+      //
+      static void
+      signature (std::string&, const void* prefix, const odb::query_base&);
+
+      static std::size_t
+      hash (const std::string&);
+
+      static std::size_t
+      parameter_count (const odb::query_base&);
+
+      // Return the cached entry (moved to the front of the LRU list) or
+      // NULL. An entry whose statement is in use by an active result is
+      // not returned.
+      //
+      entry*
+      find (std::size_t hash, const std::string& signature);
+
+      entry*
+      insert (std::size_t hash, const std::string& signature);
+
+      // Remove the entry from the cache and delete it.
+      //
+      void
+      erase (entry_list::iterator);
+
+      void
+      evict ();
+
+      // Create the parameters from the dynamic query values and bind
+      // them.
+      //
+      static void
+      bind_parameters (parameters&, const odb::query_base&);
+
+    private:
+      connection& conn_;
+      std::size_t max_size_;
+
+      entry_list list_; // Most recently used first.
+      entry_map map_;
+
+      std::size_t hits_;
+      std::size_t misses_;
+      std::size_t evictions_;
+    };
+  }
+}
+
+#include <odb/sqlite/query-cache.ixx>
+#include <odb/sqlite/query-cache.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_QUERY_CACHE_HXX
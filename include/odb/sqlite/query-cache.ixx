@@ -0,0 +1,294 @@
+// file      : odb/sqlite/query-cache.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <cstring> // std::memset
+
+namespace odb
+{
+  namespace sqlite
+  {
+    inline dynamic_query_cache::
+    dynamic_query_cache (connection& c, std::size_t max_size)
+        : conn_ (c),
+          max_size_ (max_size),
+          hits_ (0),
+          misses_ (0),
+          evictions_ (0)
+    {
+    }
+
+    inline dynamic_query_cache::
+    ~dynamic_query_cache ()
+    {
+      clear ();
+    }
+
+    inline dynamic_query_cache::statistics_type dynamic_query_cache::
+    statistics () const
+    {
+      statistics_type r;
+      r.hits = hits_;
+      r.misses = misses_;
+      r.evictions = evictions_;
+      r.size = map_.size ();
+      return r;
+    }
+
+    inline void dynamic_query_cache::
+    clear ()
+    {
+      for (entry_list::iterator i (list_.begin ()); i != list_.end (); ++i)
+        delete *i;
+
+      list_.clear ();
+      map_.clear ();
+    }
+
+    inline void dynamic_query_cache::
+    signature (std::string& r, const void* prefix, const odb::query_base& q)
+    {
+      typedef odb::query_base::clause_type clause_type;
+      typedef odb::query_base::clause_part clause_part;
+
+      const clause_type& c (q.clause ());
+
+      r.reserve (r.size () + sizeof (prefix) +
+                 c.size () * (sizeof (char) + sizeof (void*)));
+
+      r.append (reinterpret_cast<const char*> (&prefix), sizeof (prefix));
+
+      for (clause_type::const_iterator i (c.begin ()); i != c.end (); ++i)
+      {
+        const clause_part& p (*i);
+
+        r += static_cast<char> (p.kind);
+
+        switch (p.kind)
+        {
+        case clause_part::kind_column:
+        case clause_part::kind_param_val:
+        case clause_part::kind_param_ref:
+          {
+            // The column identity also determines the parameter type.
+            //
+            const void* ci (p.native_info);
+            r.append (reinterpret_cast<const char*> (&ci), sizeof (ci));
+            break;
+          }
+        case clause_part::kind_native:
+          {
+            const std::string& s (q.strings ()[p.data]);
+            std::size_t n (s.size ());
+
+            r.append (reinterpret_cast<const char*> (&n), sizeof (n));
+            r += s;
+            break;
+          }
+        case clause_part::kind_true:
+        case clause_part::kind_false:
+        case clause_part::op_not:
+        case clause_part::op_null:
+        case clause_part::op_not_null:
+          break;
+        default:
+          {
+            // Binary operators (where data is the end of the left hand
+            // side) and in() (where data is the number of arguments).
+            //
+            r.append (reinterpret_cast<const char*> (&p.data),
+                      sizeof (p.data));
+            break;
+          }
+        }
+      }
+    }
+
+    inline std::size_t dynamic_query_cache::
+    hash (const std::string& s)
+    {
+      // FNV-1a.
+      //
+      unsigned long long h (14695981039346656037ULL);
+
+      for (std::string::const_iterator i (s.begin ()); i != s.end (); ++i)
+      {
+        h ^= static_cast<unsigned char> (*i);
+        h *= 1099511628211ULL;
+      }
+
+      return static_cast<std::size_t> (h);
+    }
+
+    inline std::size_t dynamic_query_cache::
+    parameter_count (const odb::query_base& q)
+    {
+      typedef odb::query_base::clause_type clause_type;
+      typedef odb::query_base::clause_part clause_part;
+
+      const clause_type& c (q.clause ());
+      std::size_t r (0);
+
+      for (clause_type::const_iterator i (c.begin ()); i != c.end (); ++i)
+      {
+        if (i->kind == clause_part::kind_param_val ||
+            i->kind == clause_part::kind_param_ref)
+          r++;
+      }
+
+      return r;
+    }
+
+    inline dynamic_query_cache::entry* dynamic_query_cache::
+    find (std::size_t h, const std::string& s)
+    {
+      std::pair<entry_map::iterator, entry_map::iterator> r (
+        map_.equal_range (h));
+
+      for (entry_map::iterator i (r.first); i != r.second; ++i)
+      {
+        entry_list::iterator li (i->second);
+        entry* e (*li);
+
+        if (e->signature != s)
+          continue;
+
+        // If the statement is still referenced by a result, then we
+        // cannot re-execute it. There may be another entry with the same
+        // signature that is free.
+        //
+        if (e->statement.count () > 1)
+          continue;
+
+        list_.splice (list_.begin (), list_, li);
+        return e;
+      }
+
+      return 0;
+    }
+
+    inline dynamic_query_cache::entry* dynamic_query_cache::
+    insert (std::size_t h, const std::string& s)
+    {
+      evict ();
+
+      entry* e (new entry);
+
+      try
+      {
+        e->hash = h;
+        e->signature = s;
+
+        list_.push_front (e);
+      }
+      catch (...)
+      {
+        delete e;
+        throw;
+      }
+
+      try
+      {
+        map_.insert (entry_map::value_type (h, list_.begin ()));
+      }
+      catch (...)
+      {
+        list_.pop_front ();
+        delete e;
+        throw;
+      }
+
+      return e;
+    }
+
+    inline void dynamic_query_cache::
+    erase (entry_list::iterator li)
+    {
+      entry* e (*li);
+
+      std::pair<entry_map::iterator, entry_map::iterator> r (
+        map_.equal_range (e->hash));
+
+      for (entry_map::iterator i (r.first); i != r.second; ++i)
+      {
+        if (i->second == li)
+        {
+          map_.erase (i);
+          break;
+        }
+      }
+
+      list_.erase (li);
+      delete e;
+    }
+
+    inline void dynamic_query_cache::
+    evict ()
+    {
+      // Make room for one more entry, starting from the least recently
+      // used one and skipping those that are in use.
+      //
+      entry_list::iterator i (list_.end ());
+
+      while (map_.size () >= max_size_ && i != list_.begin ())
+      {
+        entry_list::iterator li (--i);
+        entry* e (*li);
+
+        if (e->statement.count () > 1)
+          continue;
+
+        i = li;
+        ++i;
+        erase (li);
+        evictions_++;
+      }
+    }
+
+    inline void dynamic_query_cache::
+    bind_parameters (parameters& ps, const odb::query_base& q)
+    {
+      typedef odb::query_base::clause_type clause_type;
+      typedef odb::query_base::clause_part clause_part;
+
+      const clause_type& c (q.clause ());
+
+      ps.params.clear ();
+      ps.binds.resize (parameter_count (q));
+
+      std::size_t n (0);
+
+      for (clause_type::const_iterator i (c.begin ()); i != c.end (); ++i)
+      {
+        const clause_part& p (*i);
+
+        if (p.kind != clause_part::kind_param_val &&
+            p.kind != clause_part::kind_param_ref)
+          continue;
+
+        const odb::query_param* qp (
+          reinterpret_cast<const odb::query_param*> (p.data));
+
+        query_param_factory f (
+          reinterpret_cast<query_param_factory> (
+            p.native_info[id_sqlite].param_factory));
+
+        ps.params.push_back (
+          f (qp->value, p.kind == clause_part::kind_param_ref));
+
+        query_param& sp (*ps.params.back ());
+
+        if (sp.reference ())
+          sp.init ();
+
+        sqlite::bind& b (ps.binds[n++]);
+        std::memset (&b, 0, sizeof (b));
+        sp.bind (&b);
+      }
+
+      ps.param_binding.bind = n != 0 ? &ps.binds[0] : 0;
+      ps.param_binding.count = n;
+      ps.param_binding.version++;
+    }
+  }
+}
@@ -0,0 +1,118 @@
+// file      : odb/sqlite/query-cache.txx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/statement-cache.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename T>
+    result<T> dynamic_query_cache::
+    query (const odb::query_base& q)
+    {
+      using namespace details;
+
+      typedef object_traits_impl<T, id_sqlite> object_traits;
+      typedef typename object_traits::statements_type statements_type;
+      typedef typename object_traits::image_type image_type;
+
+      statements_type& sts (
+        conn_.statement_cache ().template find_object<T> ());
+
+      image_type& im (sts.image ());
+      binding& imb (sts.select_image_binding ());
+
+      if (im.version != sts.select_image_version () || imb.version == 0)
+      {
+        object_traits::bind (imb.bind, im, statement_select);
+        sts.select_image_version (im.version);
+        imb.version++;
+      }
+
+      std::string sig;
+      signature (sig, &object_traits::query_statement, q);
+      std::size_t h (hash (sig));
+
+      shared_ptr<select_statement> st;
+      shared_ptr<parameters> ps;
+
+      if (entry* e = find (h, sig))
+      {
+        hits_++;
+        bind_parameters (*e->params, q);
+        st = e->statement;
+        ps = e->params;
+      }
+      else
+      {
+        misses_++;
+
+        sqlite::query_base sq (q);
+
+        std::string text (object_traits::query_statement);
+        if (!sq.empty ())
+        {
+          text += ' ';
+          text += sq.clause ();
+        }
+
+        // We rely on the translated query having one parameter per
+        // parameter part in the dynamic query clause, in the same order.
+        // If that is not the case, then execute without caching.
+        //
+        if (sq.parameters_binding ().count == parameter_count (q))
+        {
+          entry* e (insert (h, sig));
+
+          try
+          {
+            e->params.reset (new (shared) parameters);
+            bind_parameters (*e->params, q);
+            e->statement.reset (
+              new (shared) select_statement (
+                conn_, text, e->params->param_binding, imb));
+          }
+          catch (...)
+          {
+            erase (list_.begin ());
+            throw;
+          }
+
+          st = e->statement;
+          ps = e->params;
+        }
+        else
+        {
+          sq.init_parameters ();
+          st.reset (
+            new (shared) select_statement (
+              conn_, text, sq.parameters_binding (), imb));
+
+          // The translated query holds on to the parameters until the
+          // result is gone.
+          //
+          st->execute ();
+
+          shared_ptr<odb::object_result_impl<T> > r (
+            new (shared) sqlite::object_result_impl<T> (sq, st, sts));
+
+          return result<T> (r);
+        }
+      }
+
+      st->execute ();
+
+      // The cache entry is not reused while the statement is referenced
+      // by the result and the result holds on to the parameters in case
+      // the entry is evicted or the cache is destroyed.
+      //
+      shared_ptr<odb::object_result_impl<T> > r (
+        new (shared) cached_result<T> (ps, st, sts));
+
+      return result<T> (r);
+    }
+  }
+}
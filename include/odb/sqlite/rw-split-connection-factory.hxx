@@ -0,0 +1,126 @@
+// file      : odb/sqlite/rw-split-connection-factory.hxx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_RW_SPLIT_CONNECTION_FACTORY_HXX
+#define ODB_SQLITE_RW_SPLIT_CONNECTION_FACTORY_HXX
+
+#include <odb/pre.hxx>
+
+#include <cstddef> // std::size_t
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/transaction-impl.hxx>
+#include <odb/sqlite/connection-factory.hxx>
+#include <odb/sqlite/affine-connection-factory.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Maintain a single dedicated write connection plus a pool of
+    // read-only connections. This factory is meant for databases in the
+    // WAL journal mode where readers do not block the writer and vice
+    // versa.
+    //
+    // Connections returned by connect() (and therefore used by the
+    // database's begin(), begin_immediate(), and begin_exclusive()
+    // functions) are always the write connection. Since there is only
+    // one, threads wanting to write are queued here rather than on the
+    // SQLite file lock. Read-only transactions should be started with
+    // begin_read_only() (or on a connection returned by
+    // connect_read_only()) which uses one of the SQLITE_OPEN_READONLY
+    // connections so that concurrent read transactions do not wait for
+    // each other or for the writer.
+    //
+    // All the connections use a private cache unless SQLITE_OPEN_SHAREDCACHE
+    // was explicitly requested in the database flags. Note that with an
+    // in-memory database the read-only connections will not see the
+    // data written via the write connection.
+    //
+    class rw_split_connection_factory: public connection_factory
+    {
+    public:
+      // The max_readers argument specifies the maximum number of
+      // concurrent read-only connections and should not be 0.
+      //
+      explicit
+      rw_split_connection_factory (std::size_t max_readers);
+
+      // Return the write connection, waiting for it to be released if
+      // it is in use.
+      //
+      virtual connection_ptr
+      connect ();
+
+      // Return one of the read-only connections, waiting for one to be
+      // released if they are all in use.
+      //
+      connection_ptr
+      connect_read_only ();
+
+      transaction_impl*
+      begin_read_only ();
+
+      virtual void
+      database (database_type&);
+
+    public:
+      typedef affine_connection_pool_factory::statistics_type
+      statistics_type;
+
+      statistics_type
+      writer_statistics ();
+
+      statistics_type
+      reader_statistics ();
+
+    private:
+      rw_split_connection_factory (const rw_split_connection_factory&);
+      rw_split_connection_factory&
+      operator= (const rw_split_connection_factory&);
+
+    protected:
+      class pool: public affine_connection_pool_factory
+      {
+      public:
+        pool (std::size_t max_connections, bool read_only);
+
+        virtual void
+        database (database_type&);
+
+      protected:
+        virtual pooled_connection_ptr
+        create ();
+
+        // Keep the writer's and readers' affinity hints separate since
+        // the same threads normally use both pools.
+        //
+        virtual slot*
+        hint () const;
+
+        virtual void
+        hint (slot*);
+
+      private:
+        struct writer_hint;
+        struct reader_hint;
+
+        bool read_only_;
+      };
+
+    protected:
+      pool writer_;
+      pool readers_;
+    };
+  }
+}
+
+#include <odb/sqlite/rw-split-connection-factory.ixx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_RW_SPLIT_CONNECTION_FACTORY_HXX
@@ -0,0 +1,149 @@
+// file      : odb/sqlite/rw-split-connection-factory.ixx
+// copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <new>    // std::bad_alloc
+#include <string>
+
+#include <odb/sqlite/exceptions.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    //
+    // rw_split_connection_factory
+    //
+
+    inline rw_split_connection_factory::
+    rw_split_connection_factory (std::size_t max_readers)
+        : writer_ (1, false), readers_ (max_readers, true)
+    {
+    }
+
+    inline connection_ptr rw_split_connection_factory::
+    connect ()
+    {
+      return writer_.connect ();
+    }
+
+    inline connection_ptr rw_split_connection_factory::
+    connect_read_only ()
+    {
+      return readers_.connect ();
+    }
+
+    inline transaction_impl* rw_split_connection_factory::
+    begin_read_only ()
+    {
+      return connect_read_only ()->begin ();
+    }
+
+    inline void rw_split_connection_factory::
+    database (database_type& db)
+    {
+      writer_.database (db);
+      readers_.database (db);
+    }
+
+    inline rw_split_connection_factory::statistics_type
+    rw_split_connection_factory::
+    writer_statistics ()
+    {
+      return writer_.statistics ();
+    }
+
+    inline rw_split_connection_factory::statistics_type
+    rw_split_connection_factory::
+    reader_statistics ()
+    {
+      return readers_.statistics ();
+    }
+
+    //
+    // rw_split_connection_factory::pool
+    //
+
+    inline rw_split_connection_factory::pool::
+    pool (std::size_t max_connections, bool read_only)
+        : affine_connection_pool_factory (max_connections),
+          read_only_ (read_only)
+    {
+    }
+
+    inline void rw_split_connection_factory::pool::
+    database (database_type& db)
+    {
+      bool first (db_ == 0);
+      db_ = &db;
+
+      if (!first)
+        return;
+
+      // Unlike the other pools, use private cache unless shared cache was
+      // explicitly requested. With shared cache, readers would contend
+      // with the writer on table locks, which is exactly what we want to
+      // avoid.
+      //
+      if ((db_->flags () & SQLITE_OPEN_SHAREDCACHE) == 0)
+        extra_flags_ |= SQLITE_OPEN_PRIVATECACHE;
+    }
+
+    inline rw_split_connection_factory::pool::slot*
+    rw_split_connection_factory::pool::
+    hint () const
+    {
+      if (read_only_)
+        return details::tls_get (thread_hint<slot, reader_hint>::value);
+      else
+        return details::tls_get (thread_hint<slot, writer_hint>::value);
+    }
+
+    inline void rw_split_connection_factory::pool::
+    hint (slot* s)
+    {
+      if (read_only_)
+        details::tls_set (thread_hint<slot, reader_hint>::value, s);
+      else
+        details::tls_set (thread_hint<slot, writer_hint>::value, s);
+    }
+
+    inline rw_split_connection_factory::pool::pooled_connection_ptr
+    rw_split_connection_factory::pool::
+    create ()
+    {
+      if (!read_only_)
+        return affine_connection_pool_factory::create ();
+
+      // SQLite does not allow both SQLITE_OPEN_READWRITE and
+      // SQLITE_OPEN_READONLY so we have to open the handle ourselves
+      // instead of passing extra flags to the connection.
+      //
+      int f ((db_->flags () & ~(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) |
+             SQLITE_OPEN_READONLY | extra_flags_);
+
+      const std::string& vfs (db_->vfs ());
+
+      sqlite3* h (0);
+      int e (sqlite3_open_v2 (db_->name ().c_str (),
+                              &h,
+                              f,
+                              vfs.empty () ? 0 : vfs.c_str ()));
+
+      if (e != SQLITE_OK)
+      {
+        if (h == 0)
+          throw std::bad_alloc ();
+
+        int ee (sqlite3_extended_errcode (h));
+        std::string m (sqlite3_errmsg (h));
+        sqlite3_close (h);
+
+        throw database_exception (e, ee, m);
+      }
+
+      return pooled_connection_ptr (
+        new (details::shared) pooled_connection (*db_, h));
+    }
+  }
+}
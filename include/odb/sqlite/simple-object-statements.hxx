@@ -7,6 +7,7 @@
 
 #include <odb/pre.hxx>
 
+#include <string>
 #include <vector>
 #include <cassert>
 #include <cstddef> // std::size_t
@@ -14,6 +15,7 @@
 #include <odb/forward.hxx>
 #include <odb/traits.hxx>
 
+#include <odb/details/unique-ptr.hxx>
 #include <odb/details/shared-ptr.hxx>
 
 #include <odb/sqlite/version.hxx>
@@ -22,6 +24,7 @@
 #include <odb/sqlite/binding.hxx>
 #include <odb/sqlite/statement.hxx>
 #include <odb/sqlite/statements-base.hxx>
+#include <odb/sqlite/partial-update.hxx>
 
 #include <odb/sqlite/details/export.hxx>
 
@@ -181,6 +184,11 @@ namespace odb
       typedef typename object_traits::image_type image_type;
       typedef typename object_traits::id_image_type id_image_type;
 
+      // Either this class or, for a polymorphic root, the class derived
+      // from it.
+      //
+      typedef typename object_traits::statements_type statements_type;
+
       typedef
       typename object_traits::pointer_cache_traits
       pointer_cache_traits;
@@ -371,9 +379,25 @@ namespace odb
         return *find_;
       }
 
+      // If the object is tracked for partial updates, then this function
+      // expects the update binding to be initialized and returns the
+      // statement that only updates the changed columns.
+      //
       update_statement_type&
       update_statement ()
       {
+        if (partial_.get () != 0)
+        {
+          partial_->cancel ();
+
+          if (!partial_->empty ())
+          {
+            if (update_statement_type* s =
+                partial_->statement (update_image_bind_))
+              return *s;
+          }
+        }
+
         if (update_ == 0)
         {
           update_.reset (
@@ -386,9 +410,35 @@ namespace odb
         return *update_;
       }
 
+      // Check whether the object with the id in the id image exists.
+      // The statement is derived from the erase statement and only
+      // looks up the id without loading any columns.
+      //
+      select_statement_type&
+      exists_statement ()
+      {
+        if (exists_ == 0)
+        {
+          std::string text (object_traits::erase_statement);
+          text.replace (0, 6, "SELECT 1"); // DELETE FROM ... WHERE ...
+
+          exists_.reset (
+            new (details::shared) select_statement_type (
+              conn_,
+              text,
+              id_image_binding_,
+              exists_result_binding_));
+        }
+
+        return *exists_;
+      }
+
       delete_statement_type&
       erase_statement ()
       {
+        if (partial_.get () != 0)
+          partial_->untrack (update_image_bind_ + update_column_count);
+
         if (erase_ == 0)
         {
           erase_.reset (
@@ -404,6 +454,9 @@ namespace odb
       delete_statement_type&
       optimistic_erase_statement ()
       {
+        if (partial_.get () != 0)
+          partial_->untrack (update_image_bind_ + update_column_count);
+
         if (od_.erase_ == 0)
         {
           od_.erase_.reset (
@@ -416,6 +469,41 @@ namespace odb
         return *od_.erase_;
       }
 
+      // Partial updates. Once an object is tracked, subsequent updates
+      // of this object on this connection only write the columns that
+      // have changed since it was tracked or last updated.
+      //
+      void
+      track (const object_type&);
+
+      void
+      untrack (const object_type&);
+
+      // Bulk operations. The generated bulk functions look the statements
+      // up once per batch, initialize the image from each element, and
+      // then call one of these to execute the statement. The image is
+      // only rebound if its version has changed, which normally happens
+      // when an element grows one of the image buffers.
+      //
+      // Execute the insert statement. Return false if the object is
+      // already persistent.
+      //
+      bool
+      bulk_persist ();
+
+      // Execute the update statement, confirming the partial update, if
+      // any, on success. Return the number of rows updated which is 0 if
+      // the object is not persistent (or has changed, for optimistic
+      // objects).
+      //
+      unsigned long long
+      bulk_update ();
+
+      // Execute the erase statement. Return the number of rows erased.
+      //
+      unsigned long long
+      bulk_erase ();
+
       // Container statement cache.
       //
       container_statement_cache_type&
@@ -505,6 +593,15 @@ namespace odb
       details::shared_ptr<update_statement_type> update_;
       details::shared_ptr<delete_statement_type> erase_;
 
+      // The exists statement has no result columns.
+      //
+      binding exists_result_binding_;
+      details::shared_ptr<select_statement_type> exists_;
+
+      // Created on the first call to track().
+      //
+      details::unique_ptr<partial_update> partial_;
+
       // Delayed loading.
       //
       struct delayed_load
@@ -70,6 +70,123 @@ namespace odb
         select_image_bind_[i].truncated = select_image_truncated_ + i;
     }
 
+    template <typename T>
+    void object_statements<T>::
+    track (const object_type& obj)
+    {
+      if (partial_.get () == 0)
+        partial_.reset (
+          new partial_update (conn_,
+                              object_traits::update_statement,
+                              update_column_count,
+                              id_column_count,
+                              id_column_count +
+                              managed_optimistic_column_count));
+
+      // Use separate images so that we don't disturb the versions of the
+      // ones that are bound to the statements.
+      //
+      image_type im;
+      bind b[update_column_count != 0 ? update_column_count : 1];
+      std::memset (b, 0, sizeof (b));
+      object_traits::init (im, obj, statement_update);
+      object_traits::bind (b, im, statement_update);
+
+      id_image_type idi;
+      bind idb[id_column_count + managed_optimistic_column_count];
+      std::memset (idb, 0, sizeof (idb));
+      object_traits::init (idi, object_traits::id (obj));
+      object_traits::bind (idb, idi);
+
+      partial_->track (b, idb);
+    }
+
+    template <typename T>
+    void object_statements<T>::
+    untrack (const object_type& obj)
+    {
+      if (partial_.get () == 0)
+        return;
+
+      id_image_type idi;
+      bind idb[id_column_count + managed_optimistic_column_count];
+      std::memset (idb, 0, sizeof (idb));
+      object_traits::init (idi, object_traits::id (obj));
+      object_traits::bind (idb, idi);
+
+      partial_->untrack (idb);
+    }
+
+    template <typename T>
+    bool object_statements<T>::
+    bulk_persist ()
+    {
+      if (image_.version != insert_image_version_ ||
+          insert_image_binding_.version == 0)
+      {
+        object_traits::bind (insert_image_bind_, image_, statement_insert);
+        insert_image_version_ = image_.version;
+        insert_image_binding_.version++;
+      }
+
+      return persist_statement ().execute ();
+    }
+
+    template <typename T>
+    unsigned long long object_statements<T>::
+    bulk_update ()
+    {
+      bool u (false);
+
+      if (image_.version != update_image_version_ ||
+          update_image_binding_.version == 0)
+      {
+        object_traits::bind (update_image_bind_, image_, statement_update);
+        update_image_version_ = image_.version;
+        update_image_binding_.version++;
+        u = true;
+      }
+
+      if (id_image_.version != update_id_image_version_ ||
+          id_image_binding_.version == 0)
+      {
+        if (id_image_.version != id_image_version_ ||
+            id_image_binding_.version == 0)
+        {
+          object_traits::bind (id_image_binding_.bind, id_image_);
+          id_image_version_ = id_image_.version;
+          id_image_binding_.version++;
+        }
+
+        update_id_image_version_ = id_image_.version;
+
+        if (!u)
+          update_image_binding_.version++;
+      }
+
+      unsigned long long r (update_statement ().execute ());
+
+      if (r != 0 && partial_.get () != 0)
+        partial_->confirm ();
+
+      return r;
+    }
+
+    template <typename T>
+    unsigned long long object_statements<T>::
+    bulk_erase ()
+    {
+      if (id_image_.version != id_image_version_ ||
+          id_image_binding_.version == 0)
+      {
+        object_traits::bind (id_image_binding_.bind, id_image_);
+        id_image_version_ = id_image_.version;
+        id_image_binding_.version++;
+      }
+
+      return erase_statement ().execute ();
+    }
+
     template <typename T>
     void object_statements<T>::
     load_delayed_ ()
@@ -87,7 +204,11 @@ namespace odb
 
         if (l.loader == 0)
         {
-          if (!object_traits::find_ (*this, &l.id))
+          // For a polymorphic root these are the root statements.
+          //
+          statements_type& sts (static_cast<statements_type&> (*this));
+
+          if (!object_traits::find_ (sts, &l.id))
             throw object_not_persistent ();
 
           object_traits::callback (db, *l.obj, callback_event::pre_load);
@@ -97,7 +218,7 @@ namespace odb
           // those before we call the post callback.
           //
           object_traits::init (*l.obj, image (), &db);
-          object_traits::load_ (*this, *l.obj); // Load containers, etc.
+          object_traits::load_ (sts, *l.obj); // Load containers, etc.
 
           if (!delayed_.empty ())
             load_delayed_ ();
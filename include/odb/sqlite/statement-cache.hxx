@@ -8,11 +8,16 @@
 #include <odb/pre.hxx>
 
 #include <map>
+#include <vector>
 #include <typeinfo>
+#include <cstddef> // std::size_t
 
 #include <odb/forward.hxx>
 #include <odb/traits.hxx>
 
+#include <odb/details/tls.hxx>
+#include <odb/details/mutex.hxx>
+#include <odb/details/atomic.hxx>
 #include <odb/details/shared-ptr.hxx>
 #include <odb/details/type-info.hxx>
 
@@ -88,6 +93,66 @@ namespace odb
                        details::shared_ptr<statements_base>,
                        details::type_info_comparator> map;
 
+      // Return this type's index in the slot table (see below). Indexes
+      // are allocated on first use and are the same for all the
+      // connections.
+      //
+      template <typename T>
+      static std::size_t
+      index ();
+
+      // This is a template only to allow the definition in the header.
+      //
+      template <typename X>
+      struct index_counter
+      {
+        static details::atomic_count next;
+      };
+
+      // Slot table that maps type indexes to the statements in map_. It
+      // cannot be a data member without changing the layout of this
+      // class in the library so it is kept in map_ itself, owned by a
+      // special entry, and the table last used by each thread is
+      // remembered in a thread-local pointer.
+      //
+      // Tables are never freed but are returned to a free list when their
+      // cache is destroyed. This way a stale thread-local pointer can
+      // always be dereferenced and checked against the owner.
+      //
+      struct index_table
+      {
+        const statement_cache* owner;
+        std::vector<statements_base*> slots;
+        index_table* next;
+      };
+
+      struct index_entry: statements_base
+      {
+        index_entry (connection_type&, const statement_cache&);
+
+        virtual
+        ~index_entry ();
+
+        index_table* table;
+      };
+
+      template <typename X>
+      struct index_pool
+      {
+        static index_table* free;
+        static details::mutex mutex;
+        static ODB_TLS_POINTER (index_table) current;
+      };
+
+      index_table&
+      table ();
+
+      // Add the statements to map_ and to the slot table.
+      //
+      template <typename T>
+      void
+      insert (const details::shared_ptr<statements_base>&);
+
       connection& conn_;
 
       details::shared_ptr<generic_statement> begin_;
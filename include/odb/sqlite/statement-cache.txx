@@ -2,10 +2,108 @@
 // copyright : Copyright (c) 2005-2013 Code Synthesis Tools CC
 // license   : GNU GPL v2; see accompanying LICENSE file
 
+#include <odb/details/lock.hxx>
+
 namespace odb
 {
   namespace sqlite
   {
+    template <typename X>
+    details::atomic_count statement_cache::index_counter<X>::next = 0;
+
+    template <typename X>
+    statement_cache::index_table* statement_cache::index_pool<X>::free = 0;
+
+    template <typename X>
+    details::mutex statement_cache::index_pool<X>::mutex;
+
+    template <typename X>
+    ODB_TLS_POINTER (statement_cache::index_table)
+    statement_cache::index_pool<X>::current;
+
+    template <typename T>
+    inline std::size_t statement_cache::
+    index ()
+    {
+      static const std::size_t i (
+        details::atomic_add (index_counter<void>::next, 1) - 1);
+      return i;
+    }
+
+    //
+    // index_entry
+    //
+
+    inline statement_cache::index_entry::
+    index_entry (connection_type& c, const statement_cache& owner)
+        : statements_base (c)
+    {
+      details::lock l (index_pool<void>::mutex);
+
+      if (index_pool<void>::free != 0)
+      {
+        table = index_pool<void>::free;
+        index_pool<void>::free = table->next;
+      }
+      else
+        table = new index_table;
+
+      table->owner = &owner;
+      table->next = 0;
+    }
+
+    inline statement_cache::index_entry::
+    ~index_entry ()
+    {
+      details::lock l (index_pool<void>::mutex);
+
+      table->owner = 0;
+      table->slots.clear ();
+      table->next = index_pool<void>::free;
+      index_pool<void>::free = table;
+    }
+
+    //
+    // statement_cache
+    //
+
+    inline statement_cache::index_table& statement_cache::
+    table ()
+    {
+      index_table* t (details::tls_get (index_pool<void>::current));
+
+      if (t != 0 && t->owner == this)
+        return *t;
+
+      map::iterator i (map_.find (&typeid (index_entry)));
+
+      if (i == map_.end ())
+      {
+        details::shared_ptr<statements_base> p (
+          new (details::shared) index_entry (conn_, *this));
+
+        i = map_.insert (map::value_type (&typeid (index_entry), p)).first;
+      }
+
+      t = static_cast<index_entry&> (*i->second).table;
+      details::tls_set (index_pool<void>::current, t);
+      return *t;
+    }
+
+    template <typename T>
+    void statement_cache::
+    insert (const details::shared_ptr<statements_base>& p)
+    {
+      index_table& t (table ());
+      std::size_t i (index<T> ());
+
+      if (i >= t.slots.size ())
+        t.slots.resize (i + 1, 0);
+
+      map_.insert (map::value_type (&typeid (T), p));
+      t.slots[i] = p.get ();
+    }
+
     template <typename T>
     typename object_traits_impl<T, id_sqlite>::statements_type&
     statement_cache::
@@ -15,15 +113,16 @@ namespace odb
       typename object_traits_impl<T, id_sqlite>::statements_type
       statements_type;
 
-      map::iterator i (map_.find (&typeid (T)));
+      index_table& t (table ());
+      std::size_t i (index<T> ());
 
-      if (i != map_.end ())
-        return static_cast<statements_type&> (*i->second);
+      if (i < t.slots.size () && t.slots[i] != 0)
+        return static_cast<statements_type&> (*t.slots[i]);
 
       details::shared_ptr<statements_type> p (
         new (details::shared) statements_type (conn_));
 
-      map_.insert (map::value_type (&typeid (T), p));
+      insert<T> (p);
       return *p;
     }
 
@@ -31,15 +130,16 @@ namespace odb
     view_statements<T>& statement_cache::
     find_view ()
     {
-      map::iterator i (map_.find (&typeid (T)));
+      index_table& t (table ());
+      std::size_t i (index<T> ());
 
-      if (i != map_.end ())
-        return static_cast<view_statements<T>&> (*i->second);
+      if (i < t.slots.size () && t.slots[i] != 0)
+        return static_cast<view_statements<T>&> (*t.slots[i]);
 
       details::shared_ptr<view_statements<T> > p (
         new (details::shared) view_statements<T> (conn_));
 
-      map_.insert (map::value_type (&typeid (T), p));
+      insert<T> (p);
       return *p;
     }
   }
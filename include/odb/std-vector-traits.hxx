@@ -31,8 +31,7 @@ namespace odb
     static void
     persist (const container_type& c, const functions& f)
     {
-      for (index_type i (0), n (c.size ()); i < n; ++i)
-        f.insert (i, c[i]);
+      insert_range (f, c, 0, c.size ());
     }
 
     static void
@@ -52,9 +51,7 @@ namespace odb
     update (const container_type& c, const functions& f)
     {
       f.delete_ ();
-
-      for (index_type i (0), n (c.size ()); i < n; ++i)
-        f.insert (i, c[i]);
+      insert_range (f, c, 0, c.size ());
     }
 
     static void
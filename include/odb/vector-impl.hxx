@@ -110,6 +110,29 @@ namespace odb
     element_state_type
     state (std::size_t) const;
 
+    // Return the position of the first changed (inserted, updated, or
+    // erased) element at or after the specified position or size() if
+    // there are none. Unchanged elements are skipped in blocks of 64 at
+    // a time so that finding a few changes in a large vector does not
+    // require examining every element.
+    //
+    std::size_t
+    next_changed (std::size_t) const;
+
+    // Return the end of the run of elements that have the same change
+    // state as the element at the specified position. Together with
+    // next_changed() this allows iterating over the changes as runs:
+    //
+    // for (std::size_t b (impl.next_changed (0)); b != impl.size ();)
+    // {
+    //   std::size_t e (impl.run_end (b));
+    //   ... // Elements in [b, e) are all in state (b).
+    //   b = impl.next_changed (e);
+    // }
+    //
+    std::size_t
+    run_end (std::size_t) const;
+
     // Change notifications.
     //
     void
@@ -148,6 +171,17 @@ namespace odb
     void
     set (std::size_t, element_state_type);
 
+    // Number of elements in a block that is tested as a whole.
+    //
+    static const std::size_t block_size = 64;
+
+    // Return true if all the elements in the block starting at the
+    // specified (block-aligned) position have the state encoded in
+    // the pattern.
+    //
+    bool
+    block_equal (std::size_t, unsigned long long pattern) const;
+
     static const unsigned char mask_[4];
     static const unsigned char shift_[4];
 
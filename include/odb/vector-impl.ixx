@@ -2,6 +2,8 @@
 // copyright : Copyright (c) 2009-2013 Code Synthesis Tools CC
 // license   : GNU GPL v2; see accompanying LICENSE file
 
+#include <cstring> // std::memcpy
+
 #ifdef ODB_CXX11
 #  include <utility> // std::swap
 #else
@@ -99,6 +101,66 @@ namespace odb
     return static_cast<element_state_type> ((v & mask_[r]) >> shift_[r]);
   }
 
+  inline std::size_t vector_impl::
+  next_changed (std::size_t i) const
+  {
+    std::size_t n (size_);
+
+    // Examine elements one by one until the block boundary.
+    //
+    for (; i < n && i % block_size != 0; ++i)
+      if (state (i) != state_unchanged)
+        return i;
+
+    // Skip blocks of unchanged elements (all bits zero).
+    //
+    while (i + block_size <= n && block_equal (i, 0))
+      i += block_size;
+
+    for (; i < n; ++i)
+      if (state (i) != state_unchanged)
+        break;
+
+    return i;
+  }
+
+  inline std::size_t vector_impl::
+  run_end (std::size_t i) const
+  {
+    std::size_t n (size_);
+    element_state_type s (state (i));
+
+    for (++i; i < n && i % block_size != 0; ++i)
+      if (state (i) != s)
+        return i;
+
+    // Every 2-bit entry in the pattern is s.
+    //
+    unsigned long long p (
+      static_cast<unsigned long long> (s) * 0x5555555555555555ULL);
+
+    while (i + block_size <= n && block_equal (i, p))
+      i += block_size;
+
+    for (; i < n; ++i)
+      if (state (i) != s)
+        break;
+
+    return i;
+  }
+
+  inline bool vector_impl::
+  block_equal (std::size_t i, unsigned long long p) const
+  {
+    // A block is 16 bytes which we test as two 64-bit words (compilers
+    // turn this into a single vector comparison where available). The
+    // data buffer is not necessarily aligned so copy the words out.
+    //
+    unsigned long long w[block_size / 32];
+    std::memcpy (w, data_ + i / 4, sizeof (w));
+    return ((w[0] ^ p) | (w[1] ^ p)) == 0;
+  }
+
   inline void vector_impl::
   modify (std::size_t i, std::size_t n)
   {
@@ -33,8 +33,7 @@ namespace odb
     static void
     persist (const container_type& c, const functions& f)
     {
-      for (index_type i (0), n (c.size ()); i < n; ++i)
-        f.insert (i, c[i]);
+      insert_range (f, c, 0, c.size ());
 
       // Now that this container is persistent, start tracking changes.
       //
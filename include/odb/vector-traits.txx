@@ -13,10 +13,15 @@ namespace odb
     if (c._tracking ())
     {
       const vector_impl& impl (c._impl ());
+      std::size_t n (impl.size ());
 
-      for (std::size_t i (0), n (impl.size ()); i < n; ++i)
+      // Only visit the runs of changed elements. Erased elements can
+      // only be at the back and we delete them all in one go.
+      //
+      for (std::size_t b (impl.next_changed (0)); b != n;)
       {
-        vector_impl::element_state_type s (impl.state (i));
+        std::size_t e (impl.run_end (b));
+        vector_impl::element_state_type s (impl.state (b));
 
         switch (s)
         {
@@ -26,28 +31,36 @@ namespace odb
           }
         case vector_impl::state_inserted:
           {
-            f.insert (i, c[static_cast<index_type> (i)]);
-            u = u || true;
+            // See insert_range() for how runs are batched.
+            //
+            insert_range (f,
+                          c,
+                          static_cast<index_type> (b),
+                          static_cast<index_type> (e));
             break;
           }
         case vector_impl::state_updated:
           {
-            f.update (i, c[static_cast<index_type> (i)]);
-            u = u || true;
+            // There is no multi-row UPDATE so this is still one statement
+            // per element. Only finding the elements got cheaper.
+            //
+            for (std::size_t i (b); i != e; ++i)
+              f.update (i, c[static_cast<index_type> (i)]);
             break;
           }
         case vector_impl::state_erased:
           {
-            f.delete_ (i); // Delete from i onwards.
-            u = u || true;
+            f.delete_ (b); // Delete from b onwards.
             break;
           }
         }
 
-        // We delete all trailing elements in one go.
-        //
+        u = true;
+
         if (s == vector_impl::state_erased)
           break;
+
+        b = impl.next_changed (e);
       }
     }
     else
@@ -55,9 +68,7 @@ namespace odb
       // Fall back to delete all/insert all.
       //
       f.delete_ (0);
-
-      for (index_type i (0), n (c.size ()); i < n; ++i)
-        f.insert (i, c[i]);
+      insert_range (f, c, 0, c.size ());
 
       u = true;
     }